@@ -2,7 +2,6 @@
 #include <QAction>
 #include <QFileDialog>
 #include <QDirIterator>
-#include <regex>
 #include <filesystem>
 
 #include <obs-module.h>
@@ -12,8 +11,13 @@
 #include "switcher-data.hpp"
 #include "status-control.hpp"
 #include "scene-switch-helpers.hpp"
+#include "allocation-counter.hpp"
 #include "curl-helper.hpp"
+#include "deadline-scheduler.hpp"
+#include "fade-scheduler.hpp"
+#include "key-press-queue.hpp"
 #include "platform-funcs.hpp"
+#include "ui-refresh.hpp"
 #include "utility.hpp"
 #include "version.h"
 
@@ -39,6 +43,7 @@ AdvSceneSwitcher::~AdvSceneSwitcher()
 	if (switcher) {
 		switcher->settingsWindowOpened = false;
 		switcher->lastOpenedTab = ui->tabWidget->currentIndex();
+		switcher->InvalidateSaveCache();
 	}
 }
 
@@ -128,10 +133,15 @@ static void SaveSceneSwitcher(obs_data_t *save_data, bool saving, void *)
 	}
 
 	if (saving) {
-		std::lock_guard<std::mutex> lock(switcher->m);
-		switcher->Prune();
+		// The lock is held for the whole save, but only modified macros
+		// and settings sections are serialized again, everything else
+		// is reused from the previous save
 		obs_data_t *obj = obs_data_create();
-		switcher->SaveSettings(obj);
+		{
+			std::lock_guard<std::mutex> lock(switcher->m);
+			switcher->Prune();
+			switcher->SaveSettings(obj);
+		}
 		obs_data_set_obj(save_data, "advanced-scene-switcher", obj);
 		obs_data_release(obj);
 	} else {
@@ -197,6 +207,7 @@ void SwitcherData::Thread()
 	std::chrono::milliseconds duration;
 	auto startTime = std::chrono::high_resolution_clock::now();
 	auto endTime = std::chrono::high_resolution_clock::now();
+	uint64_t allocationsAtStart = 0;
 	switcher->firstIntervalAfterStop = true;
 
 	while (true) {
@@ -216,6 +227,7 @@ void SwitcherData::Thread()
 			std::chrono::duration_cast<std::chrono::milliseconds>(
 				endTime - startTime);
 
+		bool wakeUpForDeadline = false;
 		if (sleep) {
 			duration = std::chrono::milliseconds(sleep);
 		} else {
@@ -226,13 +238,23 @@ void SwitcherData::Thread()
 				     "detected busy loop - refusing to sleep less than 1ms");
 				duration = std::chrono::milliseconds(50);
 			}
+			// Wake up exactly when a time based condition is due,
+			// unless the sleep has to include the linger duration
+			const auto deadline =
+				DeadlineScheduler::TimeUntilNextDeadline();
+			if (!linger && deadline && *deadline < duration) {
+				duration = *deadline;
+				wakeUpForDeadline = true;
+			}
 		}
 
 		vblog(LOG_INFO, "try to sleep for %ld", duration.count());
 		SetWaitScene();
 		cv.wait_for(lock, duration);
+		deadlineCheck = wakeUpForDeadline;
 
 		startTime = std::chrono::high_resolution_clock::now();
+		allocationsAtStart = GetThreadAllocationCount();
 		sleep = 0;
 		linger = 0;
 
@@ -288,6 +310,13 @@ void SwitcherData::Thread()
 		writeSceneInfoToFile();
 		switcher->firstInterval = false;
 		switcher->firstIntervalAfterStop = false;
+
+		if (AllocationCountingEnabled()) {
+			const auto allocations = GetThreadAllocationCount() -
+						 allocationsAtStart;
+			vblog(LOG_INFO, "interval performed %llu allocations",
+			      static_cast<unsigned long long>(allocations));
+		}
 	}
 
 	mainLoopLock = nullptr;
@@ -300,21 +329,8 @@ void SwitcherData::SetPreconditions()
 	lastTitle = currentTitle;
 	std::string title;
 	GetCurrentWindowTitle(title);
-	for (auto &window : ignoreWindowsSwitches) {
-		bool equals = (title == window);
-		bool matches = false;
-		if (!equals) {
-			try {
-				std::regex expr(window);
-				matches = std::regex_match(title, expr);
-
-			} catch (const std::regex_error &) {
-			}
-		}
-		if (equals || matches) {
-			title = lastTitle;
-			break;
-		}
+	if (ignoreWindowsFilter.Matches(ignoreWindowsSwitches, title)) {
+		title = lastTitle;
 	}
 	currentTitle = title;
 
@@ -325,7 +341,7 @@ void SwitcherData::SetPreconditions()
 	std::pair<int, int> cursorPos = GetCursorPos();
 	cursorPosChanged = cursorPos.first != switcher->lastCursorPos.first ||
 			   cursorPos.second != switcher->lastCursorPos.second;
-	lastCursorPos = GetCursorPos();
+	lastCursorPos = cursorPos;
 }
 
 void SwitcherData::ResetForNextInterval()
@@ -451,7 +467,7 @@ void SwitcherData::Stop()
 		stop = true;
 		cv.notify_all();
 		abortMacroWait = true;
-		macroWaitCv.notify_all();
+		InterruptMacroWaits();
 		macroTransitionCv.notify_all();
 
 		// Not waiting if a dialog was closed is a workaround to avoid
@@ -515,9 +531,35 @@ bool SwitcherData::AnySceneTransitionStarted()
 /******************************************************************************
  * OBS module setup
  ******************************************************************************/
+static void invalidateSaveCache(void *, calldata_t *data)
+{
+	// Sources are saved by name, so cached settings referring to them
+	// might be outdated
+	if (!switcher) {
+		return;
+	}
+	const char *name = nullptr;
+	if (!calldata_get_string(data, "prev_name", &name)) {
+		auto source = static_cast<obs_source_t *>(
+			calldata_ptr(data, "source"));
+		name = obs_source_get_name(source);
+	}
+	switcher->InvalidateSaveCache(name ? name : "");
+}
+
 extern "C" void FreeSceneSwitcher()
 {
+	signal_handler_t *sh = obs_get_signal_handler();
+	signal_handler_disconnect(sh, "source_rename", invalidateSaveCache,
+				  nullptr);
+	signal_handler_disconnect(sh, "source_destroy", invalidateSaveCache,
+				  nullptr);
+
+	// Held keys are released using the platform specific functions
+	KeyPressQueue::Cleanup();
 	PlatformCleanup();
+	FadeScheduler::Cleanup();
+	CleanupUIRefresh();
 
 	delete switcher;
 	switcher = nullptr;
@@ -769,6 +811,12 @@ extern "C" void InitSceneSwitcher(obs_module_t *module, translateFunc translate)
 	obs_frontend_add_save_callback(SaveSceneSwitcher, nullptr);
 	obs_frontend_add_event_callback(OBSEvent, switcher);
 
+	signal_handler_t *sh = obs_get_signal_handler();
+	signal_handler_connect(sh, "source_rename", invalidateSaveCache,
+			       nullptr);
+	signal_handler_connect(sh, "source_destroy", invalidateSaveCache,
+			       nullptr);
+
 	QAction *action = (QAction *)obs_frontend_add_tools_menu_qaction(
 		obs_module_text("AdvSceneSwitcher.pluginName"));
 	action->connect(action, &QAction::triggered, OpenSettingsWindow);
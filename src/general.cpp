@@ -2,10 +2,12 @@
 #include "switcher-data.hpp"
 #include "status-control.hpp"
 #include "file-selection.hpp"
+#include "settings-snapshot.hpp"
 #include "utility.hpp"
 #include "version.h"
 
 #include <QFileDialog>
+#include <algorithm>
 
 namespace advss {
 
@@ -136,6 +138,9 @@ void AdvSceneSwitcher::closeEvent(QCloseEvent *)
 	switcher->macroListMacroEditSplitterPosition =
 		ui->macroListMacroEditSplitter->sizes();
 
+	// Settings which were not displayed might still refer to items which
+	// were renamed while the settings window was opened
+	switcher->InvalidateSaveCache();
 	obs_frontend_save();
 }
 
@@ -245,26 +250,39 @@ void AdvSceneSwitcher::SetDeprecationWarnings()
 
 void AdvSceneSwitcher::on_exportSettings_clicked()
 {
+	const QString snapshotFilter = obs_module_text(
+		"AdvSceneSwitcher.generalTab.saveOrLoadsettings.snapshotType");
+	const QString textFilter = obs_module_text(
+		"AdvSceneSwitcher.generalTab.saveOrLoadsettings.textType");
+	QString selectedFilter;
 	QString directory = QFileDialog::getSaveFileName(
 		this,
 		tr(obs_module_text(
 			"AdvSceneSwitcher.generalTab.saveOrLoadsettings.exportWindowTitle")),
 		GetDefaultSettingsSaveLocation(),
-		tr(obs_module_text(
-			"AdvSceneSwitcher.generalTab.saveOrLoadsettings.textType")));
+		textFilter + ";;" + snapshotFilter, &selectedFilter);
 	if (directory.isEmpty()) {
 		return;
 	}
 
-	QFile file(directory);
-	if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-		return;
-	}
-
 	obs_data_t *obj = obs_data_create();
 	switcher->SaveSettings(obj);
-	obs_data_save_json(obj, file.fileName().toUtf8().constData());
+	bool saved = false;
+	if (selectedFilter == snapshotFilter ||
+	    directory.endsWith(".advss", Qt::CaseInsensitive)) {
+		saved = SaveSettingsSnapshot(obj, directory);
+	} else {
+		QFile file(directory);
+		saved = file.open(QIODevice::WriteOnly | QIODevice::Text) &&
+			obs_data_save_json(
+				obj, file.fileName().toUtf8().constData());
+	}
 	obs_data_release(obj);
+
+	if (!saved) {
+		(void)DisplayMessage(obs_module_text(
+			"AdvSceneSwitcher.generalTab.saveOrLoadsettings.saveFail"));
+	}
 }
 
 void AdvSceneSwitcher::on_importSettings_clicked()
@@ -276,24 +294,20 @@ void AdvSceneSwitcher::on_importSettings_clicked()
 
 	auto basePath = FileSelection::ValidPathOrDesktop(
 		QString::fromStdString(switcher->lastImportPath));
+	const QString textFilter = obs_module_text(
+		"AdvSceneSwitcher.generalTab.saveOrLoadsettings.textType");
+	const QString snapshotFilter = obs_module_text(
+		"AdvSceneSwitcher.generalTab.saveOrLoadsettings.snapshotType");
 	QString path = QFileDialog::getOpenFileName(
 		this,
 		tr(obs_module_text(
 			"AdvSceneSwitcher.generalTab.saveOrLoadsettings.importWindowTitle")),
-		basePath,
-		tr(obs_module_text(
-			"AdvSceneSwitcher.generalTab.saveOrLoadsettings.textType")));
+		basePath, textFilter + ";;" + snapshotFilter);
 	if (path.isEmpty()) {
 		return;
 	}
 
-	QFile file(path);
-	if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-		return;
-	}
-
-	obs_data_t *obj = obs_data_create_from_json_file(
-		file.fileName().toUtf8().constData());
+	obs_data_t *obj = LoadSettingsSnapshot(path);
 
 	if (!obj) {
 		(void)DisplayMessage(obs_module_text(
@@ -489,6 +503,8 @@ void SwitcherData::LoadSettings(obs_data_t *obj)
 		return;
 	}
 
+	InvalidateSaveCache();
+
 	// Needs to be loaded before any entries which might rely on scene group
 	// selections to be available.
 	loadSceneGroups(obj);
@@ -525,29 +541,94 @@ void SwitcherData::SaveSettings(obs_data_t *obj)
 		return;
 	}
 
+	{
+		std::lock_guard<std::mutex> lock(changedSourceNamesMutex);
+		savedChangedSourceNames.swap(changedSourceNames);
+		changedSourceNames.clear();
+	}
+
 	saveSceneGroups(obj);
 	SaveMacros(obj);
 	SaveConnections(obj);
 	SaveVariables(obj);
-	saveWindowTitleSwitches(obj);
-	saveScreenRegionSwitches(obj);
-	savePauseSwitches(obj);
-	saveSceneSequenceSwitches(obj);
-	saveSceneTransitions(obj);
-	saveIdleSwitches(obj);
-	saveExecutableSwitches(obj);
-	saveRandomSwitches(obj);
-	saveFileSwitches(obj);
-	saveMediaSwitches(obj);
-	saveTimeSwitches(obj);
-	saveAudioSwitches(obj);
-	saveVideoSwitches(obj);
-	saveNetworkSwitches(obj);
-	saveSceneTriggers(obj);
+	SaveLegacySwitches(obj);
 	SaveGeneralSettings(obj);
 	SaveHotkeys(obj);
 	SaveUISettings(obj);
 	SaveVersion(obj, g_GIT_SHA1);
+
+	savedChangedSourceNames.clear();
+}
+
+void SwitcherData::InvalidateSaveCache(const std::string &sourceName)
+{
+	if (sourceName.empty()) {
+		return;
+	}
+
+	// Cached settings are searched for the name as it appears in their
+	// JSON representation, which only matches names not requiring escaping
+	const bool escaped = std::any_of(
+		sourceName.begin(), sourceName.end(), [](char c) {
+			return c == '"' || c == '\\' ||
+			       static_cast<unsigned char>(c) < 0x20;
+		});
+	std::lock_guard<std::mutex> lock(changedSourceNamesMutex);
+	if (escaped || changedSourceNames.size() >= 100) {
+		changedSourceNames.clear();
+		InvalidateSaveCache();
+		return;
+	}
+	changedSourceNames.emplace_back(sourceName);
+}
+
+bool SwitcherData::SaveCacheRefersToChangedSource(obs_data_t *cachedData) const
+{
+	if (savedChangedSourceNames.empty() || !cachedData) {
+		return false;
+	}
+	const char *json = obs_data_get_json(cachedData);
+	if (!json) {
+		return true;
+	}
+	const std::string settings = json;
+	for (const auto &name : savedChangedSourceNames) {
+		if (settings.find(name) != std::string::npos) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// The legacy tabs can only be modified using the settings window, so their
+// serialized settings can be reused as long as it was not opened
+void SwitcherData::SaveLegacySwitches(obs_data_t *obj)
+{
+	const uint64_t saveGeneration = saveCacheGeneration;
+	if (!legacySwitchesSaveData || settingsWindowOpened ||
+	    legacySwitchesSaveGeneration != saveGeneration ||
+	    SaveCacheRefersToChangedSource(legacySwitchesSaveData)) {
+		obs_data_t *data = obs_data_create();
+		saveWindowTitleSwitches(data);
+		saveScreenRegionSwitches(data);
+		savePauseSwitches(data);
+		saveSceneSequenceSwitches(data);
+		saveSceneTransitions(data);
+		saveIdleSwitches(data);
+		saveExecutableSwitches(data);
+		saveRandomSwitches(data);
+		saveFileSwitches(data);
+		saveMediaSwitches(data);
+		saveTimeSwitches(data);
+		saveAudioSwitches(data);
+		saveVideoSwitches(data);
+		saveNetworkSwitches(data);
+		saveSceneTriggers(data);
+		legacySwitchesSaveData = data;
+		obs_data_release(data);
+		legacySwitchesSaveGeneration = saveGeneration;
+	}
+	obs_data_apply(obj, legacySwitchesSaveData);
 }
 
 void SwitcherData::SaveGeneralSettings(obs_data_t *obj)
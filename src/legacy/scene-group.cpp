@@ -265,6 +265,7 @@ void AdvSceneSwitcher::on_sceneGroupName_editingFinished()
 		std::lock_guard<std::mutex> lock(switcher->m);
 		if (nameValid) {
 			currentSG->name = newName.toUtf8().constData();
+			switcher->InvalidateSaveCache();
 			QListWidgetItem *sgItem =
 				ui->sceneGroups->currentItem();
 			sgItem->setData(Qt::UserRole, newName);
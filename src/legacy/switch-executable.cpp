@@ -95,14 +95,33 @@ bool SwitcherData::checkExeSwitch(OBSWeakSource &scene,
 
 	// Check for match
 	GetProcessList(runningProcesses);
-	for (ExecutableSwitch &s : executableSwitches) {
+
+	std::vector<QString> patterns;
+	patterns.reserve(executableSwitches.size());
+	for (const auto &s : executableSwitches) {
+		patterns.emplace_back(s.exe);
+	}
+	executableSwitchMatcher.SetPatterns(patterns);
+
+	// Check all running processes against all switches at once
+	std::vector<bool> processMatches(executableSwitches.size(), false);
+	for (const auto &process : runningProcesses) {
+		const auto &result = executableSwitchMatcher.Match(process);
+		for (size_t i = 0; i < result.size(); i++) {
+			if (result[i]) {
+				processMatches[i] = true;
+			}
+		}
+	}
+
+	for (size_t i = 0; i < executableSwitches.size(); i++) {
+		auto &s = executableSwitches[i];
 		if (!s.initialized()) {
 			continue;
 		}
 
 		bool equals = runningProcesses.contains(s.exe);
-		bool matches = (runningProcesses.indexOf(
-					QRegularExpression(s.exe)) != -1);
+		bool matches = processMatches[i];
 		bool focus = (!s.inFocus || IsInFocus(s.exe));
 
 		// True if current window is ignored AND switch equals OR matches last window
@@ -97,16 +97,13 @@ void SwitcherData::writeSceneInfoToFile()
 		return;
 	}
 
-	QFile file(QString::fromStdString(fileIO.writePath));
-	if (file.open(QIODevice::WriteOnly)) {
-		// switcher->currentScene cannot be used here as scene might
-		// have changed already
-		obs_source_t *source = obs_frontend_get_current_scene();
-		auto msg = obs_source_get_name(source);
-		obs_source_release(source);
-		file.write(msg, qstrlen(msg));
-		file.close();
-	}
+	// switcher->currentScene cannot be used here as scene might
+	// have changed already
+	obs_source_t *source = obs_frontend_get_current_scene();
+	const char *name = obs_source_get_name(source);
+	std::string msg = name ? name : "";
+	obs_source_release(source);
+	statusFileWriter.Write(fileIO.writePath, msg);
 }
 
 void SwitcherData::writeToStatusFile(const QString &msg)
@@ -115,16 +112,7 @@ void SwitcherData::writeToStatusFile(const QString &msg)
 		return;
 	}
 
-	QFile file(QString::fromStdString(fileIO.writePath));
-	if (file.open(QIODevice::ReadWrite)) {
-		QTextStream stream(&file);
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-		stream << msg << endl;
-#else
-		stream << msg << Qt::endl;
-#endif
-	}
-	file.close();
+	statusFileWriter.Write(fileIO.writePath, msg.toStdString() + "\n");
 }
 
 bool SwitcherData::checkSwitchInfoFromFile(OBSWeakSource &scene,
@@ -3,8 +3,6 @@
 #include "platform-funcs.hpp"
 #include "utility.hpp"
 
-#include <regex>
-
 namespace advss {
 
 bool IdleData::pause = false;
@@ -17,31 +15,10 @@ bool SwitcherData::checkIdleSwitch(OBSWeakSource &scene,
 		return false;
 	}
 
-	std::string title = switcher->currentTitle;
-	bool ignoreIdle = false;
+	const bool ignoreIdle = ignoreIdleWindowsFilter.Matches(
+		ignoreIdleWindows, switcher->currentTitle);
 	bool match = false;
 
-	for (std::string &window : ignoreIdleWindows) {
-		if (window == title) {
-			ignoreIdle = true;
-			break;
-		}
-	}
-
-	if (!ignoreIdle) {
-		for (std::string &window : ignoreIdleWindows) {
-			try {
-				bool matches = std::regex_match(
-					title, std::regex(window));
-				if (matches) {
-					ignoreIdle = true;
-					break;
-				}
-			} catch (const std::regex_error &) {
-			}
-		}
-	}
-
 	if (!ignoreIdle && SecondsSinceLastInput() > idleData.time) {
 		if (idleData.alreadySwitched) {
 			return false;
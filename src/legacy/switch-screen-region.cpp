@@ -71,6 +71,7 @@ void AdvSceneSwitcher::on_screenRegionAdd_clicked()
 {
 	std::lock_guard<std::mutex> lock(switcher->m);
 	switcher->screenRegionSwitches.emplace_back();
+	switcher->screenRegionsChanged = true;
 
 	listAddClicked(ui->screenRegionSwitches,
 		       new ScreenRegionWidget(
@@ -92,6 +93,7 @@ void AdvSceneSwitcher::on_screenRegionRemove_clicked()
 		int idx = ui->screenRegionSwitches->currentRow();
 		auto &switches = switcher->screenRegionSwitches;
 		switches.erase(switches.begin() + idx);
+		switcher->screenRegionsChanged = true;
 	}
 
 	delete item;
@@ -116,6 +118,7 @@ void AdvSceneSwitcher::on_screenRegionUp_clicked()
 
 	std::swap(switcher->screenRegionSwitches[index],
 		  switcher->screenRegionSwitches[index - 1]);
+	switcher->screenRegionsChanged = true;
 }
 
 void AdvSceneSwitcher::on_screenRegionDown_clicked()
@@ -138,6 +141,7 @@ void AdvSceneSwitcher::on_screenRegionDown_clicked()
 
 	std::swap(switcher->screenRegionSwitches[index],
 		  switcher->screenRegionSwitches[index + 1]);
+	switcher->screenRegionsChanged = true;
 }
 
 bool shouldIgnoreSceneSwitch(ScreenRegionSwitch &matchingRegion)
@@ -156,37 +160,39 @@ bool SwitcherData::checkScreenRegionSwitch(OBSWeakSource &scene,
 		return false;
 	}
 
+	if (screenRegionsChanged) {
+		std::vector<RegionIndex::Region> regions;
+		regions.reserve(screenRegionSwitches.size());
+		for (const auto &s : screenRegionSwitches) {
+			regions.push_back({s.minX, s.minY, s.maxX, s.maxY});
+		}
+		screenRegionIndex.Build(regions);
+		screenRegionsChanged = false;
+	}
+
 	std::pair<int, int> cursorPos = GetCursorPos();
-	int minRegionSize = 99999;
-	bool match = false;
+	static thread_local std::vector<size_t> containingRegions;
+	screenRegionIndex.Query(cursorPos.first, cursorPos.second,
+				containingRegions);
 
-	for (auto &s : screenRegionSwitches) {
+	for (const auto idx : containingRegions) {
+		auto &s = screenRegionSwitches[idx];
 		if (!s.initialized()) {
 			continue;
 		}
-
-		if (cursorPos.first >= s.minX && cursorPos.second >= s.minY &&
-		    cursorPos.first <= s.maxX && cursorPos.second <= s.maxY) {
-			int regionSize = (s.maxX - s.minX) + (s.maxY - s.minY);
-			if (regionSize < minRegionSize) {
-				if (shouldIgnoreSceneSwitch(s)) {
-					// We technically have a match.
-					// But just ignore it.
-					return false;
-				}
-				match = true;
-				scene = s.getScene();
-				transition = s.transition;
-				minRegionSize = regionSize;
-
-				if (verbose) {
-					s.logMatch();
-				}
-				break;
-			}
+		if (shouldIgnoreSceneSwitch(s)) {
+			// We technically have a match.
+			// But just ignore it.
+			return false;
+		}
+		scene = s.getScene();
+		transition = s.transition;
+		if (verbose) {
+			s.logMatch();
 		}
+		return true;
 	}
-	return match;
+	return false;
 }
 
 void AdvSceneSwitcher::updateScreenRegionCursorPos()
@@ -214,6 +220,7 @@ void SwitcherData::saveScreenRegionSwitches(obs_data_t *obj)
 void SwitcherData::loadScreenRegionSwitches(obs_data_t *obj)
 {
 	screenRegionSwitches.clear();
+	screenRegionsChanged = true;
 
 	obs_data_array_t *screenRegionArray =
 		obs_data_get_array(obj, "screenRegion");
@@ -403,6 +410,7 @@ void ScreenRegionWidget::MinXChanged(int pos)
 
 	std::lock_guard<std::mutex> lock(switcher->m);
 	switchData->minX = pos;
+	switcher->screenRegionsChanged = true;
 
 	drawFrame();
 }
@@ -415,6 +423,7 @@ void ScreenRegionWidget::MinYChanged(int pos)
 
 	std::lock_guard<std::mutex> lock(switcher->m);
 	switchData->minY = pos;
+	switcher->screenRegionsChanged = true;
 
 	drawFrame();
 }
@@ -427,6 +436,7 @@ void ScreenRegionWidget::MaxXChanged(int pos)
 
 	std::lock_guard<std::mutex> lock(switcher->m);
 	switchData->maxX = pos;
+	switcher->screenRegionsChanged = true;
 
 	drawFrame();
 }
@@ -439,6 +449,7 @@ void ScreenRegionWidget::MaxYChanged(int pos)
 
 	std::lock_guard<std::mutex> lock(switcher->m);
 	switchData->maxY = pos;
+	switcher->screenRegionsChanged = true;
 
 	drawFrame();
 }
@@ -1,5 +1,6 @@
 #include "advanced-scene-switcher.hpp"
 #include "switcher-data.hpp"
+#include "deadline-scheduler.hpp"
 #include "utility.hpp"
 
 namespace advss {
@@ -76,53 +77,104 @@ void AdvSceneSwitcher::on_timeDown_clicked()
 		  switcher->timeSwitches[index + 1]);
 }
 
-bool timesAreInInterval(QTime &time1, QTime &time2, int &interval)
+static bool triggersOnDate(const TimeSwitch &s, const QDate &date)
 {
-	if (time1.isNull() || time2.isNull()) {
-		return false;
-	}
-
-	bool ret = false;
-	QTime validSwitchTimeWindow = time1.addMSecs(interval);
-
-	ret = time1 <= time2 && time2 <= validSwitchTimeWindow;
-	// Check for overflow
-	if (!ret && validSwitchTimeWindow.msecsSinceStartOfDay() < interval) {
-		ret = time2 >= time1 || time2 <= validSwitchTimeWindow;
-	}
-	return ret;
+	return s.trigger == ANY_DAY || s.trigger == date.dayOfWeek();
 }
 
-bool checkLiveTime(TimeSwitch &s, QDateTime &start, int &interval)
+static QDateTime getLiveTriggerTime(const TimeSwitch &s,
+				    const QDateTime &liveTime)
 {
-	if (start.isNull()) {
-		return false;
+	if (liveTime.isNull()) {
+		return {};
 	}
+	return liveTime.addMSecs(s.time.msecsSinceStartOfDay());
+}
 
-	QDateTime now = QDateTime::currentDateTime();
-	QTime timePassed = QTime(0, 0).addMSecs(start.msecsTo(now));
+// The switcher thread might check the switches more than once per interval
+// to wake up exactly when a switch is due, so each switch only matches if its
+// time was reached since the previous check
+static bool timeReachedSince(const QDateTime &time, const QDateTime &from,
+			     const QDateTime &now)
+{
+	return time.isValid() && from < time && time <= now;
+}
 
-	return timesAreInInterval(s.time, timePassed, interval);
+static bool checkLiveTime(const TimeSwitch &s, const QDateTime &liveTime,
+			  const QDateTime &from, const QDateTime &now)
+{
+	return timeReachedSince(getLiveTriggerTime(s, liveTime), from, now);
 }
 
-bool checkRegularTime(TimeSwitch &s, int &interval)
+static bool checkRegularTime(const TimeSwitch &s, const QDateTime &from,
+			     const QDateTime &now)
 {
-	if (s.trigger != ANY_DAY &&
-	    s.trigger != QDate::currentDate().dayOfWeek())
-		return false;
+	// The previous check might have happened before midnight
+	for (QDate date = from.date(); date <= now.date();
+	     date = date.addDays(1)) {
+		if (triggersOnDate(s, date) &&
+		    timeReachedSince(QDateTime(date, s.time), from, now)) {
+			return true;
+		}
+	}
+	return false;
+}
 
-	QTime now = QTime::currentTime();
+static QDateTime getNextTriggerTime(const TimeSwitch &s,
+				    const QDateTime &liveTime,
+				    const QDateTime &now)
+{
+	if (s.trigger == LIVE) {
+		const auto time = getLiveTriggerTime(s, liveTime);
+		return time > now ? time : QDateTime();
+	}
+	for (int i = 0; i <= 7; i++) {
+		const QDate date = now.date().addDays(i);
+		const QDateTime time(date, s.time);
+		if (triggersOnDate(s, date) && time > now) {
+			return time;
+		}
+	}
+	return {};
+}
 
-	return timesAreInInterval(s.time, now, interval);
+void SwitcherData::scheduleTimeSwitches(const QDateTime &now)
+{
+	QDateTime next;
+	for (TimeSwitch &s : timeSwitches) {
+		if (!s.initialized()) {
+			continue;
+		}
+		const auto time = getNextTriggerTime(s, liveTime, now);
+		if (time.isValid() && (!next.isValid() || time < next)) {
+			next = time;
+		}
+	}
+	if (next.isValid()) {
+		DeadlineScheduler::Set(&timeSwitches, next.toMSecsSinceEpoch());
+	} else {
+		DeadlineScheduler::Remove(&timeSwitches);
+	}
 }
 
 bool SwitcherData::checkTimeSwitch(OBSWeakSource &scene,
 				   OBSWeakSource &transition)
 {
 	if (TimeSwitch::pause) {
+		DeadlineScheduler::Remove(&timeSwitches);
 		return false;
 	}
 
+	// Times which were reached while the switcher was stopped or busy for
+	// longer than the check interval are not matched anymore
+	const QDateTime now = QDateTime::currentDateTime();
+	QDateTime from = now.addMSecs(-interval);
+	if (lastTimeSwitchCheck.isValid() && lastTimeSwitchCheck > from) {
+		from = lastTimeSwitchCheck;
+	}
+	lastTimeSwitchCheck = now;
+	scheduleTimeSwitches(now);
+
 	bool match = false;
 	for (TimeSwitch &s : timeSwitches) {
 		if (!s.initialized()) {
@@ -130,9 +182,9 @@ bool SwitcherData::checkTimeSwitch(OBSWeakSource &scene,
 		}
 
 		if (s.trigger == LIVE) {
-			match = checkLiveTime(s, liveTime, interval);
+			match = checkLiveTime(s, liveTime, from, now);
 		} else {
-			match = checkRegularTime(s, interval);
+			match = checkRegularTime(s, from, now);
 		}
 
 		if (match) {
@@ -3,8 +3,6 @@
 #include "platform-funcs.hpp"
 #include "utility.hpp"
 
-#include <regex>
-
 namespace advss {
 
 bool WindowSwitch::pause = false;
@@ -191,19 +189,30 @@ void checkWindowTitleSwitchDirect(WindowSwitch &s,
 	}
 }
 
-void checkWindowTitleSwitchRegex(WindowSwitch &s,
-				 std::string &currentWindowTitle,
-				 std::vector<std::string> windowList,
-				 bool &match, OBSWeakSource &scene,
-				 OBSWeakSource &transition)
+static void matchWindows(MultiPatternMatcher &matcher,
+			 const std::vector<std::string> &windowList,
+			 std::vector<std::vector<bool>> &windowMatches)
 {
-	for (auto &window : windowList) {
-		try {
-			std::regex expr(s.window);
-			if (!std::regex_match(window, expr)) {
-				continue;
-			}
-		} catch (const std::regex_error &) {
+	windowMatches.reserve(windowList.size());
+	for (const auto &window : windowList) {
+		windowMatches.emplace_back(
+			matcher.Match(QString::fromStdString(window)));
+	}
+}
+
+void checkWindowTitleSwitchRegex(
+	WindowSwitch &s, size_t switchIdx, const MultiPatternMatcher &matcher,
+	std::string &currentWindowTitle,
+	const std::vector<std::string> &windowList,
+	const std::vector<std::vector<bool>> &windowMatches, bool &match,
+	OBSWeakSource &scene, OBSWeakSource &transition)
+{
+	for (size_t i = 0; i < windowList.size(); i++) {
+		const auto &window = windowList[i];
+		// Invalid expressions were always treated as matching
+		if (matcher.IsValid(switchIdx) &&
+		    !windowMatches[i][switchIdx]) {
+			continue;
 		}
 
 		bool focus = (!s.focus || window == currentWindowTitle);
@@ -230,7 +239,18 @@ bool SwitcherData::checkWindowTitleSwitch(OBSWeakSource &scene,
 	std::vector<std::string> windowList;
 	GetWindowList(windowList);
 
-	for (WindowSwitch &s : windowSwitches) {
+	std::vector<QString> patterns;
+	patterns.reserve(windowSwitches.size());
+	for (const auto &s : windowSwitches) {
+		patterns.emplace_back(QString::fromStdString(s.window));
+	}
+	windowSwitchMatcher.SetPatterns(patterns);
+
+	// Each window is only checked against all switches once
+	std::vector<std::vector<bool>> windowMatches;
+
+	for (size_t i = 0; i < windowSwitches.size(); i++) {
+		auto &s = windowSwitches[i];
 		if (!s.initialized()) {
 			continue;
 		}
@@ -240,9 +260,14 @@ bool SwitcherData::checkWindowTitleSwitch(OBSWeakSource &scene,
 			checkWindowTitleSwitchDirect(s, currentWindowTitle,
 						     match, scene, transition);
 		} else {
-			checkWindowTitleSwitchRegex(s, currentWindowTitle,
-						    windowList, match, scene,
-						    transition);
+			if (windowMatches.empty()) {
+				matchWindows(windowSwitchMatcher, windowList,
+					     windowMatches);
+			}
+			checkWindowTitleSwitchRegex(s, i, windowSwitchMatcher,
+						    currentWindowTitle,
+						    windowList, windowMatches,
+						    match, scene, transition);
 		}
 
 		if (match) {
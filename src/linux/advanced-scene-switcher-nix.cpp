@@ -7,6 +7,9 @@
 #include <X11/keysym.h>
 #include <X11/extensions/scrnsaver.h>
 #include <X11/extensions/XTest.h>
+#ifdef USE_XINPUT2
+#include <X11/extensions/XInput2.h>
+#endif
 #undef Bool
 #undef CursorShape
 #undef Expose
@@ -19,9 +22,19 @@
 #undef Status
 #undef Unsorted
 #include <util/platform.h>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <optional>
 #include <vector>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
+#include <dirent.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
 #include <QStringList>
 #include <QRegularExpression>
 #include <QLibrary>
@@ -30,8 +43,6 @@
 #else
 #include <libproc2/pids.h>
 #endif
-#include <fstream>
-#include <sstream>
 
 namespace advss {
 
@@ -49,9 +60,20 @@ static XScreenSaverAllocInfoFunc allocSSFunc = nullptr;
 static XScreenSaverQueryInfoFunc querySSFunc = nullptr;
 bool canGetIdleTime = false;
 
-std::chrono::high_resolution_clock::time_point lastMouseLeftClickTime{};
-std::chrono::high_resolution_clock::time_point lastMouseMiddleClickTime{};
-std::chrono::high_resolution_clock::time_point lastMouseRightClickTime{};
+#ifdef USE_XINPUT2
+static QLibrary *libXiHandle = nullptr;
+typedef int (*XIQueryVersionFunc)(Display *, int *, int *);
+typedef int (*XISelectEventsFunc)(Display *, Window, XIEventMask *, int);
+static XIQueryVersionFunc queryXIVersionFunc = nullptr;
+static XISelectEventsFunc selectXIEventsFunc = nullptr;
+#endif
+
+std::atomic<std::chrono::high_resolution_clock::time_point>
+	lastMouseLeftClickTime{};
+std::atomic<std::chrono::high_resolution_clock::time_point>
+	lastMouseMiddleClickTime{};
+std::atomic<std::chrono::high_resolution_clock::time_point>
+	lastMouseRightClickTime{};
 
 Display *disp()
 {
@@ -72,264 +94,471 @@ void cleanupDisplay()
 	xdisplay = 0;
 }
 
-static bool ewmhIsSupported()
+// Errors caused by the window tracker are expected, as windows can be
+// destroyed at any time, so they must not be forwarded to the default error
+// handler, which would terminate the process
+static Display *trackerDisplay = nullptr;
+static XErrorHandler previousErrorHandler = nullptr;
+
+static int handleXError(Display *display, XErrorEvent *event)
 {
-	Display *display = disp();
-	if (!display) {
-		return false;
+	if (display == trackerDisplay) {
+		return 0;
 	}
-	auto window = DefaultRootWindow(display);
-	if (!window) {
-		return false;
+	return previousErrorHandler ? previousErrorHandler(display, event) : 0;
+}
+
+static std::string getWindowName(Display *display, Window window)
+{
+	if (!display || !window) {
+		return "";
+	}
+	std::string windowTitle;
+	char *name;
+	int status = XFetchName(display, window, &name);
+	if (status >= Success && name != nullptr) {
+		std::string str(name);
+		windowTitle = str;
+		XFree(name);
+	} else {
+		XTextProperty xtp_new_name;
+		if (XGetWMName(display, window, &xtp_new_name) != 0 &&
+		    xtp_new_name.value != nullptr) {
+			std::string str((const char *)xtp_new_name.value);
+			windowTitle = str;
+			XFree(xtp_new_name.value);
+		}
 	}
 
-	Atom netSupportingWmCheck =
-		XInternAtom(display, "_NET_SUPPORTING_WM_CHECK", true);
+	return windowTitle;
+}
+
+static std::vector<unsigned long> getProperty(Display *display, Window window,
+					      Atom property, Atom type)
+{
+	std::vector<unsigned long> result;
 	Atom actualType;
 	int format = 0;
 	unsigned long num = 0, bytes = 0;
-	unsigned char *data = NULL;
-	Window ewmhWindow = 0;
-
-	int status = XGetWindowProperty(display, window, netSupportingWmCheck,
-					0L, 1L, false, XA_WINDOW, &actualType,
-					&format, &num, &bytes, &data);
-
-	if (status == Success) {
-		if (num > 0) {
-			ewmhWindow = ((Window *)data)[0];
-		}
-		if (data) {
-			XFree(data);
-			data = NULL;
-		}
+	unsigned char *data = nullptr;
+	int status = XGetWindowProperty(display, window, property, 0L, ~0L,
+					false, type, &actualType, &format, &num,
+					&bytes, &data);
+	if (status != Success || !data) {
+		return result;
 	}
-
-	if (ewmhWindow) {
-		status = XGetWindowProperty(display, ewmhWindow,
-					    netSupportingWmCheck, 0L, 1L, false,
-					    XA_WINDOW, &actualType, &format,
-					    &num, &bytes, &data);
-		if (status != Success || num == 0 ||
-		    ewmhWindow != ((Window *)data)[0]) {
-			ewmhWindow = 0;
-		}
-		if (status == Success && data) {
-			XFree(data);
-		}
+	// Format 32 properties are always returned as an array of longs
+	if (format == 32) {
+		auto values = reinterpret_cast<unsigned long *>(data);
+		result.assign(values, values + num);
 	}
-	return ewmhWindow != 0;
+	XFree(data);
+	return result;
 }
 
-static QStringList getStates(Window window)
-{
-	QStringList states;
-	if (!window || !ewmhIsSupported()) {
-		return states;
-	}
+namespace {
+
+struct TrackedWindow {
+	std::string title;
+	long pid = -1;
+	bool fullscreen = false;
+	bool maximizedVert = false;
+	bool maximizedHorz = false;
+};
 
-	Atom wmState = XInternAtom(disp(), "_NET_WM_STATE", true), type;
-	int format;
-	unsigned long num, bytes;
-	unsigned char *data;
+// Keeps a table of all top level windows and their properties up to date by
+// listening for property changes using a separate connection to the X server.
+// This way window queries do not require any round trips to the X server.
+class WindowTracker {
+public:
+	bool Start();
+	void Stop();
+
+	// Iterates the windows in the order of _NET_CLIENT_LIST until the
+	// callback returns false
+	void ForEachWindow(const std::function<bool(const TrackedWindow &)> &);
+	bool GetActiveWindow(TrackedWindow &);
+
+private:
+	enum AtomIdx {
+		SUPPORTING_WM_CHECK,
+		CLIENT_LIST,
+		ACTIVE_WINDOW,
+		WM_NAME,
+		NET_WM_NAME,
+		WM_STATE,
+		WM_STATE_FULLSCREEN,
+		WM_STATE_MAXIMIZED_VERT,
+		WM_STATE_MAXIMIZED_HORZ,
+		WM_PID,
+		ATOM_COUNT,
+	};
 
-	int status = XGetWindowProperty(disp(), window, wmState, 0, ~0L, false,
-					AnyPropertyType, &type, &format, &num,
-					&bytes, &data);
+	void Thread();
+	void HandleEvent(const XPropertyEvent &);
+	bool IsRootWindow(Window) const;
+	void UpdateEwmhSupport();
+	void UpdateClientList();
+	void UpdateActiveWindow();
+	void UpdateTitle(Window);
+	void UpdateStates(Window);
+	void UpdatePid(Window);
+	void ReadStates(Window, TrackedWindow &);
+	long ReadPid(Window);
+
+	Display *_display = nullptr;
+	Atom _atoms[ATOM_COUNT] = {};
+	std::thread _thread;
+	std::atomic_bool _stop = {false};
+	bool _ewmhSupported = false;
+
+	std::mutex _mutex;
+	std::vector<Window> _clientList;
+	std::unordered_map<Window, TrackedWindow> _windows;
+	Window _activeWindow = 0;
+};
 
-	if (status == Success) {
-		for (unsigned long i = 0; i < num; i++) {
-			states.append(QString(
-				XGetAtomName(disp(), ((Atom *)data)[i])));
-		}
-		XFree(data);
-	}
+} // namespace
 
-	return states;
-}
+static WindowTracker windowTracker;
 
-static std::vector<Window> getTopLevelWindows()
+bool WindowTracker::Start()
 {
-	std::vector<Window> res;
-	if (!ewmhIsSupported()) {
-		return res;
+	_display = XOpenDisplay(NULL);
+	if (!_display) {
+		return false;
 	}
 
-	Atom netClList = XInternAtom(disp(), "_NET_CLIENT_LIST", true);
-	Atom actualType;
-	int format;
-	unsigned long num, bytes;
-	Window *data = 0;
+	// Intern all atoms using a single round trip
+	static const char *atomNames[ATOM_COUNT] = {
+		"_NET_SUPPORTING_WM_CHECK",
+		"_NET_CLIENT_LIST",
+		"_NET_ACTIVE_WINDOW",
+		"WM_NAME",
+		"_NET_WM_NAME",
+		"_NET_WM_STATE",
+		"_NET_WM_STATE_FULLSCREEN",
+		"_NET_WM_STATE_MAXIMIZED_VERT",
+		"_NET_WM_STATE_MAXIMIZED_HORZ",
+		"_NET_WM_PID",
+	};
+	XInternAtoms(_display, const_cast<char **>(atomNames), ATOM_COUNT,
+		     false, _atoms);
 
-	for (int i = 0; i < ScreenCount(disp()); ++i) {
-		Window rootWindow = RootWindow(disp(), i);
-		if (!rootWindow) {
-			continue;
-		}
+	trackerDisplay = _display;
+	previousErrorHandler = XSetErrorHandler(handleXError);
+
+	_stop = false;
+	_thread = std::thread([this]() { Thread(); });
+	return true;
+}
+
+void WindowTracker::Stop()
+{
+	if (!_display) {
+		return;
+	}
+	_stop = true;
+	if (_thread.joinable()) {
+		_thread.join();
+	}
 
-		int status = XGetWindowProperty(disp(), rootWindow, netClList,
-						0L, ~0L, false, AnyPropertyType,
-						&actualType, &format, &num,
-						&bytes, (uint8_t **)&data);
+	// Only restore the previous handler if nobody replaced ours meanwhile
+	auto current = XSetErrorHandler(previousErrorHandler);
+	if (current != handleXError) {
+		XSetErrorHandler(current);
+	}
+	trackerDisplay = nullptr;
+	XCloseDisplay(_display);
+	_display = nullptr;
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_clientList.clear();
+	_windows.clear();
+	_activeWindow = 0;
+}
 
-		if (status != Success) {
+void WindowTracker::ForEachWindow(
+	const std::function<bool(const TrackedWindow &)> &callback)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	for (const auto window : _clientList) {
+		auto it = _windows.find(window);
+		if (it == _windows.end()) {
 			continue;
 		}
-
-		for (unsigned long i = 0; i < num; ++i) {
-			res.emplace_back(data[i]);
+		if (!callback(it->second)) {
+			return;
 		}
-
-		XFree(data);
 	}
+}
 
-	return res;
+bool WindowTracker::GetActiveWindow(TrackedWindow &window)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto it = _windows.find(_activeWindow);
+	if (it == _windows.end()) {
+		return false;
+	}
+	window = it->second;
+	return true;
 }
 
-std::string getWindowName(Window window)
+void WindowTracker::Thread()
 {
-	auto display = disp();
-	if (!display || !window) {
-		return "";
+	for (int i = 0; i < ScreenCount(_display); i++) {
+		XSelectInput(_display, RootWindow(_display, i),
+			     PropertyChangeMask);
 	}
-	std::string windowTitle;
-	char *name;
-	int status = XFetchName(display, window, &name);
-	if (status >= Success && name != nullptr) {
-		std::string str(name);
-		windowTitle = str;
-		XFree(name);
-	} else {
-		XTextProperty xtp_new_name;
-		if (XGetWMName(display, window, &xtp_new_name) != 0 &&
-		    xtp_new_name.value != nullptr) {
-			std::string str((const char *)xtp_new_name.value);
-			windowTitle = str;
-			XFree(xtp_new_name.value);
+	UpdateEwmhSupport();
+
+	pollfd fd = {ConnectionNumber(_display), POLLIN, 0};
+	while (!_stop) {
+		while (XPending(_display)) {
+			XEvent event;
+			XNextEvent(_display, &event);
+			if (event.type == PropertyNotify) {
+				HandleEvent(event.xproperty);
+			}
 		}
+		// Wake up regularly to check if the tracker should stop
+		poll(&fd, 1, 100);
 	}
-
-	return windowTitle;
 }
 
-void GetWindowList(std::vector<std::string> &windows)
+void WindowTracker::HandleEvent(const XPropertyEvent &event)
 {
-	windows.resize(0);
-	for (auto window : getTopLevelWindows()) {
-		auto name = getWindowName(window);
-		if (name.empty()) {
-			continue;
+	if (IsRootWindow(event.window)) {
+		if (event.atom == _atoms[SUPPORTING_WM_CHECK]) {
+			UpdateEwmhSupport();
+		} else if (!_ewmhSupported) {
+			return;
+		} else if (event.atom == _atoms[CLIENT_LIST]) {
+			UpdateClientList();
+		} else if (event.atom == _atoms[ACTIVE_WINDOW]) {
+			UpdateActiveWindow();
 		}
-		windows.emplace_back(name);
+		return;
+	}
+
+	if (event.atom == _atoms[WM_NAME] ||
+	    event.atom == _atoms[NET_WM_NAME]) {
+		UpdateTitle(event.window);
+	} else if (event.atom == _atoms[WM_STATE]) {
+		UpdateStates(event.window);
+	} else if (event.atom == _atoms[WM_PID]) {
+		UpdatePid(event.window);
 	}
 }
 
-void GetWindowList(QStringList &windows)
+bool WindowTracker::IsRootWindow(Window window) const
 {
-	windows.clear();
-	for (auto window : getTopLevelWindows()) {
-		auto name = getWindowName(window);
-		if (name.empty()) {
-			continue;
+	for (int i = 0; i < ScreenCount(_display); i++) {
+		if (RootWindow(_display, i) == window) {
+			return true;
 		}
-		windows << QString::fromStdString(name);
 	}
+	return false;
 }
 
-int getActiveWindow(Window *&window)
+void WindowTracker::UpdateEwmhSupport()
 {
-	if (!ewmhIsSupported()) {
-		return -1;
+	auto root = DefaultRootWindow(_display);
+	auto check = getProperty(_display, root, _atoms[SUPPORTING_WM_CHECK],
+				 XA_WINDOW);
+	Window ewmhWindow = check.empty() ? 0 : check[0];
+	if (ewmhWindow) {
+		// The window must refer to itself to not be a stale leftover
+		// of a window manager which is no longer running
+		check = getProperty(_display, ewmhWindow,
+				    _atoms[SUPPORTING_WM_CHECK], XA_WINDOW);
+		if (check.empty() || check[0] != ewmhWindow) {
+			ewmhWindow = 0;
+		}
 	}
+	_ewmhSupported = ewmhWindow != 0;
 
-	Atom active = XInternAtom(disp(), "_NET_ACTIVE_WINDOW", true);
-	Atom actualType;
-	int format;
-	unsigned long num, bytes;
-
-	auto rootWindow = DefaultRootWindow(disp());
-	if (!rootWindow) {
-		return -2;
+	if (_ewmhSupported) {
+		UpdateClientList();
+		UpdateActiveWindow();
+		return;
 	}
 
-	return XGetWindowProperty(disp(), rootWindow, active, 0L, ~0L, false,
-				  AnyPropertyType, &actualType, &format, &num,
-				  &bytes, (uint8_t **)&window);
+	std::lock_guard<std::mutex> lock(_mutex);
+	_clientList.clear();
+	_windows.clear();
+	_activeWindow = 0;
 }
 
-void GetCurrentWindowTitle(std::string &title)
+void WindowTracker::UpdateClientList()
 {
-	Window *data = 0;
-	if (getActiveWindow(data) != Success || !data) {
-		return;
+	std::vector<Window> clientList;
+	for (int i = 0; i < ScreenCount(_display); i++) {
+		auto windows =
+			getProperty(_display, RootWindow(_display, i),
+				    _atoms[CLIENT_LIST], AnyPropertyType);
+		clientList.insert(clientList.end(), windows.begin(),
+				  windows.end());
 	}
-	if (!data[0]) {
-		XFree(data);
-		return;
+
+	// Only query the properties of windows which were not known before
+	std::vector<std::pair<Window, TrackedWindow>> newWindows;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		for (const auto window : clientList) {
+			if (_windows.find(window) == _windows.end()) {
+				newWindows.emplace_back(window,
+							TrackedWindow());
+			}
+		}
+	}
+	for (auto &[window, info] : newWindows) {
+		XSelectInput(_display, window, PropertyChangeMask);
+		info.title = getWindowName(_display, window);
+		ReadStates(window, info);
+		info.pid = ReadPid(window);
 	}
 
-	auto name = getWindowName(data[0]);
-	XFree(data);
-	if (name.empty()) {
-		return;
+	std::lock_guard<std::mutex> lock(_mutex);
+	for (auto &[window, info] : newWindows) {
+		_windows[window] = std::move(info);
+	}
+	std::unordered_map<Window, TrackedWindow> windows;
+	for (const auto window : clientList) {
+		auto it = _windows.find(window);
+		if (it != _windows.end()) {
+			windows.emplace(window, std::move(it->second));
+		}
 	}
-	title = name;
+	_windows = std::move(windows);
+	_clientList = std::move(clientList);
 }
 
-bool windowStatesAreSet(const std::string &windowTitle,
-			std::vector<QString> &expectedStates)
+void WindowTracker::UpdateActiveWindow()
 {
-	if (!ewmhIsSupported()) {
-		return false;
+	auto active = getProperty(_display, DefaultRootWindow(_display),
+				  _atoms[ACTIVE_WINDOW], AnyPropertyType);
+	std::lock_guard<std::mutex> lock(_mutex);
+	_activeWindow = active.empty() ? 0 : active[0];
+}
+
+void WindowTracker::UpdateTitle(Window window)
+{
+	auto title = getWindowName(_display, window);
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto it = _windows.find(window);
+	if (it != _windows.end()) {
+		it->second.title = std::move(title);
 	}
+}
 
-	std::vector<Window> windows = getTopLevelWindows();
-	for (auto &window : windows) {
-		auto name = getWindowName(window);
-		if (name.empty()) {
-			continue;
-		}
+void WindowTracker::ReadStates(Window window, TrackedWindow &info)
+{
+	auto states = getProperty(_display, window, _atoms[WM_STATE],
+				  AnyPropertyType);
+	auto isSet = [&states](Atom state) {
+		return std::find(states.begin(), states.end(), state) !=
+		       states.end();
+	};
+	info.fullscreen = isSet(_atoms[WM_STATE_FULLSCREEN]);
+	info.maximizedVert = isSet(_atoms[WM_STATE_MAXIMIZED_VERT]);
+	info.maximizedHorz = isSet(_atoms[WM_STATE_MAXIMIZED_HORZ]);
+}
 
-		bool equals = windowTitle == name;
-		bool matches = QString::fromStdString(name).contains(
-			QRegularExpression(
-				QString::fromStdString(windowTitle)));
+void WindowTracker::UpdateStates(Window window)
+{
+	TrackedWindow states;
+	ReadStates(window, states);
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto it = _windows.find(window);
+	if (it != _windows.end()) {
+		it->second.fullscreen = states.fullscreen;
+		it->second.maximizedVert = states.maximizedVert;
+		it->second.maximizedHorz = states.maximizedHorz;
+	}
+}
 
-		if (!(equals || matches)) {
-			continue;
-		}
+long WindowTracker::ReadPid(Window window)
+{
+	auto pid = getProperty(_display, window, _atoms[WM_PID], XA_CARDINAL);
+	return pid.empty() ? -1 : static_cast<long>(pid[0]);
+}
 
-		QStringList states = getStates(window);
-		if (states.isEmpty()) {
-			if (expectedStates.empty()) {
-				return true;
-			}
-			return false;
+void WindowTracker::UpdatePid(Window window)
+{
+	const long pid = ReadPid(window);
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto it = _windows.find(window);
+	if (it != _windows.end()) {
+		it->second.pid = pid;
+	}
+}
+
+void GetWindowList(std::vector<std::string> &windows)
+{
+	windows.resize(0);
+	windowTracker.ForEachWindow([&windows](const TrackedWindow &window) {
+		if (!window.title.empty()) {
+			windows.emplace_back(window.title);
 		}
+		return true;
+	});
+}
 
-		for (const auto &state : expectedStates) {
-			if (!states.contains(state)) {
-				return false;
-			}
+void GetWindowList(QStringList &windows)
+{
+	windows.clear();
+	windowTracker.ForEachWindow([&windows](const TrackedWindow &window) {
+		if (!window.title.empty()) {
+			windows << QString::fromStdString(window.title);
 		}
 		return true;
+	});
+}
+
+void GetCurrentWindowTitle(std::string &title)
+{
+	TrackedWindow window;
+	if (!windowTracker.GetActiveWindow(window) || window.title.empty()) {
+		return;
 	}
-	return false;
+	title = window.title;
+}
+
+static bool
+windowStatesAreSet(const std::string &windowTitle,
+		   const std::function<bool(const TrackedWindow &)> &statesSet)
+{
+	const QRegularExpression expr(QString::fromStdString(windowTitle));
+	bool result = false;
+	windowTracker.ForEachWindow([&](const TrackedWindow &window) {
+		if (window.title.empty()) {
+			return true;
+		}
+		bool equals = windowTitle == window.title;
+		bool matches =
+			QString::fromStdString(window.title).contains(expr);
+		if (!(equals || matches)) {
+			return true;
+		}
+		result = statesSet(window);
+		return false;
+	});
+	return result;
 }
 
 bool IsMaximized(const std::string &title)
 {
-	std::vector<QString> states;
-	states.emplace_back("_NET_WM_STATE_MAXIMIZED_VERT");
-	states.emplace_back("_NET_WM_STATE_MAXIMIZED_HORZ");
-	return windowStatesAreSet(title, states);
+	return windowStatesAreSet(title, [](const TrackedWindow &window) {
+		return window.maximizedVert && window.maximizedHorz;
+	});
 }
 
 bool IsFullscreen(const std::string &title)
 {
-	std::vector<QString> states;
-	states.emplace_back("_NET_WM_STATE_FULLSCREEN");
-	return windowStatesAreSet(title, states);
+	return windowStatesAreSet(title, [](const TrackedWindow &window) {
+		return window.fullscreen;
+	});
 }
 
 std::optional<std::string> GetTextInWindow(const std::string &window)
@@ -338,28 +567,70 @@ std::optional<std::string> GetTextInWindow(const std::string &window)
 	return {};
 }
 
+// Rescanning /proc more often than this is not useful as conditions are only
+// checked once per interval
+constexpr auto processScanInterval = std::chrono::milliseconds(250);
+
+static bool isPidDirectory(const char *name)
+{
+	if (!*name) {
+		return false;
+	}
+	for (; *name; ++name) {
+		if (*name < '0' || *name > '9') {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Reads the name of the process, which is cheaper than querying procps when
+// only a few processes have to be checked
+static bool readProcessComm(pid_t pid, std::string &name)
+{
+	const std::string path = "/proc/" + std::to_string(pid) + "/comm";
+	const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		return false;
+	}
+	char buffer[64];
+	const ssize_t size = read(fd, buffer, sizeof(buffer));
+	close(fd);
+	if (size < 0) {
+		return false;
+	}
+	name.assign(buffer, size);
+	if (!name.empty() && name.back() == '\n') {
+		name.pop_back();
+	}
+	return true;
+}
+
 #ifdef USE_PROCPS
-void GetProcessList(QStringList &processes)
+static void readProcessNames(const std::vector<pid_t> &pids,
+			     std::unordered_map<pid_t, std::string> &names)
 {
-	processes.clear();
-	PROCTAB *proc = openproc(PROC_FILLSTAT);
+	// The pid list passed to openproc() has to be zero terminated
+	std::vector<pid_t> pidList(pids);
+	pidList.push_back(0);
+	PROCTAB *proc = openproc(PROC_FILLSTAT | PROC_PID, pidList.data());
+	if (!proc) {
+		return;
+	}
 	proc_t proc_info;
 	memset(&proc_info, 0, sizeof(proc_info));
 	while (readproc(proc, &proc_info) != NULL) {
-		QString procName(proc_info.cmd);
-		if (!procName.isEmpty() && !processes.contains(procName)) {
-			processes << procName;
-		}
+		names[proc_info.tid] = proc_info.cmd;
 	}
 	closeproc(proc);
 }
 #else
-void GetProcessList(QStringList &processes)
+static void readProcessNames(const std::vector<pid_t> &pids,
+			     std::unordered_map<pid_t, std::string> &names)
 {
-	processes.clear();
 	struct pids_info *info = NULL;
-	struct pids_stack *stack;
 	enum pids_item Items[] = {
+		PIDS_ID_PID,
 		PIDS_CMD,
 	};
 
@@ -368,56 +639,155 @@ void GetProcessList(QStringList &processes)
 		return;
 	}
 
-	while ((stack = procps_pids_get(info, PIDS_FETCH_TASKS_ONLY))) {
-		auto cmd = PIDS_VAL(0, str, stack, info);
-		QString procName(cmd);
-		if (!procName.isEmpty() && !processes.contains(procName)) {
-			processes << procName;
+	std::vector<unsigned> pidList(pids.begin(), pids.end());
+	auto fetch = procps_pids_select(info, pidList.data(), pidList.size(),
+					PIDS_SELECT_PID);
+	if (fetch) {
+		for (int i = 0; i < fetch->counts->total; i++) {
+			auto stack = fetch->stacks[i];
+			names[PIDS_VAL(0, s_int, stack, info)] =
+				PIDS_VAL(1, str, stack, info);
 		}
 	}
 	procps_pids_unref(&info);
 }
 #endif
 
-long getForegroundProcessPid()
+namespace {
+
+// Table of the running processes, which is updated by only querying the
+// names of processes which were started since the last scan.
+// The process list is only rebuilt once a process was started, stopped or
+// changed its name.
+class ProcessTracker {
+public:
+	void GetProcessList(QStringList &processes);
+	bool GetProcessName(long pid, std::string &name);
+
+private:
+	void Update();
+
+	std::mutex _mutex;
+	std::chrono::steady_clock::time_point _lastScan{};
+	std::unordered_map<pid_t, std::string> _processes;
+	bool _processListValid = false;
+	QStringList _processList;
+};
+
+} // namespace
+
+static ProcessTracker processTracker;
+
+void ProcessTracker::Update()
 {
-	Window *window;
-	if (getActiveWindow(window) != Success || !window || !*window) {
-		return -1;
+	const auto now = std::chrono::steady_clock::now();
+	if (now - _lastScan < processScanInterval) {
+		return;
+	}
+	_lastScan = now;
+
+	DIR *dir = opendir("/proc");
+	if (!dir) {
+		return;
+	}
+	std::unordered_set<pid_t> running;
+	std::vector<pid_t> started;
+	bool changed = false;
+	std::string name;
+	while (auto entry = readdir(dir)) {
+		if (!isPidDirectory(entry->d_name)) {
+			continue;
+		}
+		const pid_t pid = std::atoi(entry->d_name);
+		running.insert(pid);
+		auto it = _processes.find(pid);
+		if (it == _processes.end()) {
+			started.emplace_back(pid);
+			continue;
+		}
+		// The pid might have been reused by a new process or the
+		// process might have called exec() since the last scan
+		if (readProcessComm(pid, name) && name != it->second) {
+			it->second = name;
+			changed = true;
+		}
 	}
-	Atom atom, actual_type;
-	int actual_format;
-	unsigned long nitems;
-	unsigned long bytes_after;
-	unsigned char *prop;
-	long long pid;
-	atom = XInternAtom(disp(), "_NET_WM_PID", True);
-	auto status = XGetWindowProperty(disp(), *window, atom, 0, 1024, False,
-					 XA_CARDINAL, &actual_type,
-					 &actual_format, &nitems, &bytes_after,
-					 &prop);
-	XFree(window);
-	if (status != 0) {
-		return -2;
+	closedir(dir);
+
+	for (auto it = _processes.begin(); it != _processes.end();) {
+		if (running.count(it->first) == 0) {
+			it = _processes.erase(it);
+			changed = true;
+		} else {
+			++it;
+		}
 	}
-	if (!prop) {
-		return -3;
+	if (!started.empty()) {
+		// Keep processes whose name cannot be read in the table to not
+		// query them again on every scan
+		for (const auto pid : started) {
+			_processes.emplace(pid, "");
+		}
+		readProcessNames(started, _processes);
+		changed = true;
 	}
+	if (changed) {
+		_processListValid = false;
+	}
+}
 
-	pid = *((long *)prop);
-	XFree(prop);
-	return pid;
+void ProcessTracker::GetProcessList(QStringList &processes)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	Update();
+	if (!_processListValid) {
+		std::unordered_set<std::string> names;
+		_processList.clear();
+		for (const auto &[_, name] : _processes) {
+			if (!name.empty() && names.insert(name).second) {
+				_processList << QString::fromStdString(name);
+			}
+		}
+		_processListValid = true;
+	}
+	processes = _processList;
+}
+
+bool ProcessTracker::GetProcessName(long pid, std::string &name)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto it = _processes.find(static_cast<pid_t>(pid));
+	if (it == _processes.end()) {
+		return false;
+	}
+	name = it->second;
+	return true;
+}
+
+void GetProcessList(QStringList &processes)
+{
+	processTracker.GetProcessList(processes);
+}
+
+long getForegroundProcessPid()
+{
+	TrackedWindow window;
+	if (!windowTracker.GetActiveWindow(window)) {
+		return -1;
+	}
+	return window.pid;
 }
 
 std::string getProcNameFromPid(long pid)
 {
-	std::string path = "/proc/" + std::to_string(pid) + "/comm";
-	std::ifstream t(path);
-	std::stringstream buffer;
-	buffer << t.rdbuf();
-	std::string name = buffer.str();
-	if (!name.empty() && name[name.length() - 1] == '\n') {
-		name.erase(name.length() - 1);
+	std::string name;
+	if (processTracker.GetProcessName(pid, name)) {
+		return name;
+	}
+
+	// The process might have been started since the last scan
+	if (!readProcessComm(static_cast<pid_t>(pid), name)) {
+		name.clear();
 	}
 	return name;
 }
@@ -450,7 +820,7 @@ bool IsInFocus(const QString &executable)
 	return (equals || matches);
 }
 
-int SecondsSinceLastInput()
+static int queryIdleSeconds()
 {
 	if (!canGetIdleTime) {
 		return 0;
@@ -466,14 +836,227 @@ int SecondsSinceLastInput()
 		return 0;
 	}
 
-	time_t idle_time;
-	auto mit_info = allocSSFunc();
+	// The info is only used by this function, so it can be reused
+	static std::mutex infoMutex;
+	static XScreenSaverInfo *info = nullptr;
+	std::lock_guard<std::mutex> lock(infoMutex);
+	if (!info) {
+		info = allocSSFunc();
+		if (!info) {
+			return 0;
+		}
+	}
+
+	auto status = querySSFunc(display, window, info);
+	return status != 0 ? info->idle / 1000 : 0;
+}
+
+#ifdef USE_XINPUT2
+
+namespace {
+
+// Keeps track of the time of the last user input, the cursor position and
+// mouse clicks by listening for raw input events of the XInput2 extension
+// using a separate connection to the X server.
+// This way none of them have to be queried from the X server when needed.
+class InputMonitor {
+public:
+	bool Start();
+	void Stop();
+	bool IsActive() const { return _display != nullptr; }
+	int SecondsSinceLastInput() const;
+	std::pair<int, int> GetCursorPos() const;
+
+private:
+	void Thread();
+	void HandleEvent(XGenericEventCookie &);
+	void UpdateCursorPos();
+
+	Display *_display = nullptr;
+	int _xiOpcode = 0;
+	std::thread _thread;
+	std::atomic_bool _stop = {false};
+
+	std::atomic<uint64_t> _lastInputTime = {0};
+	// Both coordinates are stored in a single value, so they can never be
+	// read from different updates
+	std::atomic<uint64_t> _cursorPos = {0};
+};
+
+} // namespace
+
+static InputMonitor inputMonitor;
+
+// Raw motion events are received for every movement of the device, so limit
+// how often the cursor position is queried
+constexpr uint64_t cursorQueryInterval = 10000000; // 10 ms
+constexpr int cursorQueryTimeoutMs = 10;
+
+bool InputMonitor::Start()
+{
+	if (!queryXIVersionFunc || !selectXIEventsFunc) {
+		return false;
+	}
+
+	_display = XOpenDisplay(NULL);
+	if (!_display) {
+		return false;
+	}
+
+	int _;
+	// Raw events are only delivered while another client grabs the
+	// pointer or keyboard starting with version 2.1
+	int major = 2;
+	int minor = 2;
+	if (!XQueryExtension(_display, "XInputExtension", &_xiOpcode, &_,
+			     &_) ||
+	    queryXIVersionFunc(_display, &major, &minor) != Success) {
+		XCloseDisplay(_display);
+		_display = nullptr;
+		return false;
+	}
+
+	XIEventMask mask;
+	unsigned char bits[XIMaskLen(XI_LASTEVENT)] = {};
+	XISetMask(bits, XI_RawMotion);
+	XISetMask(bits, XI_RawButtonPress);
+	XISetMask(bits, XI_RawKeyPress);
+	mask.deviceid = XIAllMasterDevices;
+	mask.mask_len = sizeof(bits);
+	mask.mask = bits;
+	selectXIEventsFunc(_display, DefaultRootWindow(_display), &mask, 1);
+
+	_lastInputTime = os_gettime_ns() -
+			 static_cast<uint64_t>(queryIdleSeconds()) * 1000000000;
+	UpdateCursorPos();
+
+	_stop = false;
+	_thread = std::thread([this]() { Thread(); });
+	return true;
+}
+
+void InputMonitor::Stop()
+{
+	if (!_display) {
+		return;
+	}
+	_stop = true;
+	if (_thread.joinable()) {
+		_thread.join();
+	}
+	XCloseDisplay(_display);
+	_display = nullptr;
+}
+
+int InputMonitor::SecondsSinceLastInput() const
+{
+	const uint64_t now = os_gettime_ns();
+	const uint64_t last = _lastInputTime;
+	return now > last ? static_cast<int>((now - last) / 1000000000) : 0;
+}
+
+std::pair<int, int> InputMonitor::GetCursorPos() const
+{
+	const uint64_t pos = _cursorPos;
+	return {static_cast<int32_t>(pos >> 32), static_cast<int32_t>(pos)};
+}
 
-	auto status = querySSFunc(display, window, mit_info);
-	idle_time = (mit_info->idle) / 1000;
-	XFree(mit_info);
+void InputMonitor::Thread()
+{
+	pollfd fd = {ConnectionNumber(_display), POLLIN, 0};
+	bool cursorMoved = false;
+	uint64_t lastCursorQuery = 0;
+	while (!_stop) {
+		while (XPending(_display)) {
+			XEvent event;
+			XNextEvent(_display, &event);
+			auto &cookie = event.xcookie;
+			if (cookie.type != GenericEvent ||
+			    cookie.extension != _xiOpcode ||
+			    !XGetEventData(_display, &cookie)) {
+				continue;
+			}
+			_lastInputTime = os_gettime_ns();
+			if (cookie.evtype == XI_RawMotion) {
+				cursorMoved = true;
+			} else {
+				HandleEvent(cookie);
+			}
+			XFreeEventData(_display, &cookie);
+		}
 
-	return status != 0 ? idle_time : 0;
+		// Wake up regularly to check if the monitor should stop
+		int timeout = 100;
+		if (cursorMoved) {
+			const uint64_t now = os_gettime_ns();
+			if (now - lastCursorQuery >= cursorQueryInterval) {
+				UpdateCursorPos();
+				lastCursorQuery = now;
+				cursorMoved = false;
+			} else {
+				// Query the final position once it is due
+				timeout = cursorQueryTimeoutMs;
+			}
+		}
+		poll(&fd, 1, timeout);
+	}
+}
+
+void InputMonitor::HandleEvent(XGenericEventCookie &cookie)
+{
+	if (cookie.evtype != XI_RawButtonPress) {
+		return;
+	}
+
+	const auto now = std::chrono::high_resolution_clock::now();
+	switch (static_cast<XIRawEvent *>(cookie.data)->detail) {
+	case Button1:
+		lastMouseLeftClickTime = now;
+		break;
+	case Button2:
+		lastMouseMiddleClickTime = now;
+		break;
+	case Button3:
+		lastMouseRightClickTime = now;
+		break;
+	default:
+		break;
+	}
+}
+
+void InputMonitor::UpdateCursorPos()
+{
+	Window root, child;
+	int x = 0, y = 0, _;
+	unsigned int mask;
+	if (!XQueryPointer(_display, DefaultRootWindow(_display), &root,
+			   &child, &x, &y, &_, &_, &mask)) {
+		return;
+	}
+	_cursorPos = (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) |
+		     static_cast<uint32_t>(y);
+}
+
+#endif
+
+int SecondsSinceLastInput()
+{
+#ifdef USE_XINPUT2
+	if (inputMonitor.IsActive()) {
+		return inputMonitor.SecondsSinceLastInput();
+	}
+#endif
+	return queryIdleSeconds();
+}
+
+std::optional<std::pair<int, int>> GetTrackedCursorPos()
+{
+#ifdef USE_XINPUT2
+	if (inputMonitor.IsActive()) {
+		return inputMonitor.GetCursorPos();
+	}
+#endif
+	return {};
 }
 
 static std::unordered_map<HotkeyType, long> keyTable = {
@@ -596,7 +1179,7 @@ static std::unordered_map<HotkeyType, long> keyTable = {
 	{HotkeyType::Key_NumpadEnter, XK_KP_Enter},
 };
 
-void PressKeys(const std::vector<HotkeyType> keys, int duration)
+void SendKeyEvents(const std::vector<KeyEvent> &events)
 {
 	if (!canSimulateKeyPresses) {
 		return;
@@ -607,30 +1190,15 @@ void PressKeys(const std::vector<HotkeyType> keys, int duration)
 		return;
 	}
 
-	// Press keys
-	for (auto &key : keys) {
-		auto it = keyTable.find(key);
+	for (const auto &event : events) {
+		auto it = keyTable.find(event.key);
 		if (it == keyTable.end()) {
 			continue;
 		}
-		pressFunc(display, XKeysymToKeycode(display, it->second), true,
-			  CurrentTime);
+		pressFunc(display, XKeysymToKeycode(display, it->second),
+			  event.pressed, CurrentTime);
 	}
 	XFlush(display);
-
-	std::this_thread::sleep_for(std::chrono::milliseconds(duration));
-
-	// Release keys
-	for (auto &key : keys) {
-		auto it = keyTable.find(key);
-		if (it == keyTable.end()) {
-			continue;
-		}
-		pressFunc(display, XKeysymToKeycode(display, it->second), false,
-			  CurrentTime);
-	}
-
-	XFlush(display);
 }
 
 void PlatformInit()
@@ -640,6 +1208,8 @@ void PlatformInit()
 		return;
 	}
 
+	windowTracker.Start();
+
 	libXtstHandle = new QLibrary("libXtst", nullptr);
 	pressFunc = (keyPressFunc)libXtstHandle->resolve("XTestFakeKeyEvent");
 	int _;
@@ -653,10 +1223,29 @@ void PlatformInit()
 		"XScreenSaverQueryInfo");
 	canGetIdleTime = allocSSFunc && querySSFunc &&
 			 XQueryExtension(disp(), ScreenSaverName, &_, &_, &_);
+
+#ifdef USE_XINPUT2
+	libXiHandle = new QLibrary("libXi", nullptr);
+	queryXIVersionFunc =
+		(XIQueryVersionFunc)libXiHandle->resolve("XIQueryVersion");
+	selectXIEventsFunc =
+		(XISelectEventsFunc)libXiHandle->resolve("XISelectEvents");
+	if (!inputMonitor.Start()) {
+		blog(LOG_INFO, "XInput2 not available - polling idle time");
+	}
+#endif
 }
 
 void PlatformCleanup()
 {
+	windowTracker.Stop();
+#ifdef USE_XINPUT2
+	inputMonitor.Stop();
+	if (libXiHandle) {
+		delete libXiHandle;
+		libXiHandle = nullptr;
+	}
+#endif
 	if (libXtstHandle) {
 		delete libXtstHandle;
 		libXtstHandle = nullptr;
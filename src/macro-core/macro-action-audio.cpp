@@ -2,6 +2,8 @@
 #include "switcher-data.hpp"
 #include "utility.hpp"
 
+#include <cmath>
+
 namespace advss {
 
 constexpr int64_t nsPerMs = 1000000;
@@ -36,49 +38,16 @@ const static std::map<MacroActionAudio::FadeType, std::string> fadeTypes = {
 	 "AdvSceneSwitcher.action.audio.fade.type.rate"},
 };
 
-constexpr auto fadeInterval = std::chrono::milliseconds(100);
-constexpr float minFade = 0.000001f;
-
-void MacroActionAudio::SetFadeActive(bool value)
-{
-	if (_action == Action::SOURCE_VOLUME) {
-		switcher->activeAudioFades[_audioSource.ToString()].active =
-			value;
-	} else {
-		switcher->masterAudioFade.active = value;
-	}
-}
-
-bool MacroActionAudio::FadeActive()
-{
-	bool active = true;
-	if (_action == Action::SOURCE_VOLUME) {
-		auto it = switcher->activeAudioFades.find(
-			_audioSource.ToString());
-		if (it == switcher->activeAudioFades.end()) {
-			return false;
-		}
-		active = it->second.active;
-	} else {
-		active = switcher->masterAudioFade.active;
-	}
-
-	return active;
-}
-
-std::atomic_int *MacroActionAudio::GetFadeIdPtr()
-{
+const static std::map<FadeCurve, std::string> fadeCurves = {
+	{FadeCurve::LINEAR, "AdvSceneSwitcher.action.audio.fade.curve.linear"},
+	{FadeCurve::EASE_IN, "AdvSceneSwitcher.action.audio.fade.curve.easeIn"},
+	{FadeCurve::EASE_OUT,
+	 "AdvSceneSwitcher.action.audio.fade.curve.easeOut"},
+	{FadeCurve::EASE_IN_OUT,
+	 "AdvSceneSwitcher.action.audio.fade.curve.easeInOut"},
+};
 
-	if (_action == Action::SOURCE_VOLUME) {
-		auto it = switcher->activeAudioFades.find(
-			_audioSource.ToString());
-		if (it == switcher->activeAudioFades.end()) {
-			return nullptr;
-		}
-		return &it->second.id;
-	}
-	return &switcher->masterAudioFade.id;
-}
+constexpr float minFade = 0.000001f;
 
 void MacroActionAudio::SetVolume(float vol)
 {
@@ -107,46 +76,26 @@ float MacroActionAudio::GetVolume()
 	return curVol;
 }
 
-void MacroActionAudio::FadeVolume()
+std::string MacroActionAudio::GetFadeKey() const
 {
-	float vol = (float)_volume / 100.0f;
-	float curVol = GetVolume();
-	bool volIncrease = curVol <= vol;
-	float volDiff = (volIncrease) ? vol - curVol : curVol - vol;
-	int nrSteps = 0;
-	float volStep = 0.;
-	if (_fadeType == FadeType::DURATION) {
-		nrSteps = _duration.Milliseconds() / fadeInterval.count();
-		volStep = volDiff / nrSteps;
-	} else {
-		volStep = _rate / 1000.0f;
-		nrSteps = volDiff / volStep;
-	}
-
-	if (volStep < minFade || nrSteps <= 1) {
-		SetVolume(vol);
-		SetFadeActive(false);
-		return;
+	if (_action == Action::SOURCE_VOLUME) {
+		return "volume:" + _audioSource.ToString();
 	}
+	return "volume:master";
+}
 
-	auto macro = GetMacro();
-	int step = 0;
-	auto fadeId = GetFadeIdPtr();
-	int expectedFadeId = ++(*fadeId);
-	for (; step < nrSteps && !macro->GetStop() && expectedFadeId == *fadeId;
-	     ++step) {
-		curVol = (volIncrease) ? curVol + volStep : curVol - volStep;
-		SetVolume(curVol);
-		std::this_thread::sleep_for(fadeInterval);
+std::chrono::milliseconds MacroActionAudio::GetFadeDuration(float from,
+							    float to) const
+{
+	if (_fadeType == FadeType::DURATION) {
+		return std::chrono::milliseconds(_duration.Milliseconds());
 	}
-
-	// As a final step set desired volume once again in case floating-point
-	// precision errors compounded to a noticeable error
-	if (step == nrSteps) {
-		SetVolume(vol);
+	const double ratePerMs = _rate / 100000.;
+	if (ratePerMs < minFade) {
+		return std::chrono::milliseconds(0);
 	}
-
-	SetFadeActive(false);
+	return std::chrono::milliseconds(
+		static_cast<int64_t>(std::abs(to - from) / ratePerMs));
 }
 
 void MacroActionAudio::StartFade()
@@ -155,7 +104,29 @@ void MacroActionAudio::StartFade()
 		return;
 	}
 
-	if (FadeActive() && !_abortActiveFade) {
+	// The source is captured by value, as the fade might outlive this
+	// action
+	FadeScheduler::SetValueFunc setVolume;
+	if (_action == Action::SOURCE_VOLUME) {
+		OBSWeakSource source = _audioSource.GetSource();
+		setVolume = [source](double vol) {
+			OBSSourceAutoRelease s =
+				obs_weak_source_get_source(source);
+			obs_source_set_volume(s, static_cast<float>(vol));
+		};
+	} else {
+		setVolume = [](double vol) {
+			obs_set_master_volume(static_cast<float>(vol));
+		};
+	}
+
+	const float vol = (float)_volume / 100.0f;
+	const float curVol = GetVolume();
+	auto fade = FadeScheduler::Start(GetFadeKey(), GetMacro(), curVol, vol,
+					 GetFadeDuration(curVol, vol),
+					 _fadeCurve, setVolume,
+					 _abortActiveFade);
+	if (!fade) {
 		blog(LOG_WARNING,
 		     "Audio fade for volume of %s already active! New fade request will be ignored!",
 		     (_action == Action::SOURCE_VOLUME)
@@ -163,13 +134,17 @@ void MacroActionAudio::StartFade()
 			     : "master volume");
 		return;
 	}
-	SetFadeActive(true);
 
-	if (_wait) {
-		FadeVolume();
+	if (!_wait) {
+		return;
+	}
+	auto macro = GetMacro();
+	if (macro->CanSuspend()) {
+		// Aborting macro waits must not abort the fade
+		macro->Suspend(false);
+		fade->OnDone([macro]() { macro->Resume(); });
 	} else {
-		GetMacro()->AddHelperThread(
-			std::thread(&MacroActionAudio::FadeVolume, this));
+		fade->Wait();
 	}
 }
 
@@ -234,6 +209,7 @@ bool MacroActionAudio::Save(obs_data_t *obj) const
 	_rate.Save(obj, "rate");
 	obs_data_set_bool(obj, "fade", _fade);
 	obs_data_set_int(obj, "fadeType", static_cast<int>(_fadeType));
+	obs_data_set_int(obj, "fadeCurve", static_cast<int>(_fadeCurve));
 	obs_data_set_bool(obj, "wait", _wait);
 	obs_data_set_bool(obj, "abortActiveFade", _abortActiveFade);
 	obs_data_set_int(obj, "version", 1);
@@ -271,6 +247,7 @@ bool MacroActionAudio::Load(obs_data_t *obj)
 	} else {
 		_fadeType = FadeType::DURATION;
 	}
+	_fadeCurve = static_cast<FadeCurve>(obs_data_get_int(obj, "fadeCurve"));
 	if (obs_data_has_user_value(obj, "abortActiveFade")) {
 		_abortActiveFade = obs_data_get_bool(obj, "abortActiveFade");
 	} else {
@@ -306,12 +283,21 @@ static inline void populateFadeTypeSelection(QComboBox *list)
 	}
 }
 
+static inline void populateFadeCurveSelection(QComboBox *list)
+{
+	for (const auto &[curve, name] : fadeCurves) {
+		list->addItem(obs_module_text(name.c_str()),
+			      static_cast<int>(curve));
+	}
+}
+
 MacroActionAudioEdit::MacroActionAudioEdit(
 	QWidget *parent, std::shared_ptr<MacroActionAudio> entryData)
 	: QWidget(parent),
 	  _sources(new SourceSelectionWidget(this, QStringList(), true)),
 	  _actions(new QComboBox),
 	  _fadeTypes(new QComboBox),
+	  _fadeCurves(new QComboBox),
 	  _syncOffset(new VariableSpinBox),
 	  _monitorTypes(new QComboBox),
 	  _balance(new SliderSpinBox(
@@ -346,6 +332,7 @@ MacroActionAudioEdit::MacroActionAudioEdit(
 	sources.sort();
 	_sources->SetSourceNameList(sources);
 	populateFadeTypeSelection(_fadeTypes);
+	populateFadeCurveSelection(_fadeCurves);
 	PopulateMonitorTypeSelection(_monitorTypes);
 
 	QWidget::connect(_actions, SIGNAL(currentIndexChanged(int)), this,
@@ -381,6 +368,8 @@ MacroActionAudioEdit::MacroActionAudioEdit(
 			 SLOT(AbortActiveFadeChanged(int)));
 	QWidget::connect(_fadeTypes, SIGNAL(currentIndexChanged(int)), this,
 			 SLOT(FadeTypeChanged(int)));
+	QWidget::connect(_fadeCurves, SIGNAL(currentIndexChanged(int)), this,
+			 SLOT(FadeCurveChanged(int)));
 
 	std::unordered_map<std::string, QWidget *> widgetPlaceholders = {
 		{"{{audioSources}}", _sources},
@@ -395,6 +384,7 @@ MacroActionAudioEdit::MacroActionAudioEdit(
 		{"{{wait}}", _wait},
 		{"{{abortActiveFade}}", _abortActiveFade},
 		{"{{fadeTypes}}", _fadeTypes},
+		{"{{fadeCurves}}", _fadeCurves},
 	};
 	QHBoxLayout *entryLayout = new QHBoxLayout;
 	PlaceWidgets(obs_module_text("AdvSceneSwitcher.action.audio.entry"),
@@ -441,12 +431,14 @@ void MacroActionAudioEdit::SetWidgetVisibility()
 	_fadeTypeLayout->removeWidget(_fadeTypes);
 	_fadeTypeLayout->removeWidget(_duration);
 	_fadeTypeLayout->removeWidget(_rate);
+	_fadeTypeLayout->removeWidget(_fadeCurves);
 	ClearLayout(_fadeTypeLayout);
 	std::unordered_map<std::string, QWidget *> widgetPlaceholders = {
 		{"{{fade}}", _fade},
 		{"{{duration}}", _duration},
 		{"{{rate}}", _rate},
 		{"{{fadeTypes}}", _fadeTypes},
+		{"{{fadeCurves}}", _fadeCurves},
 	};
 	if (_entryData->_fadeType == MacroActionAudio::FadeType::DURATION) {
 		PlaceWidgets(
@@ -496,6 +488,8 @@ void MacroActionAudioEdit::UpdateEntryData()
 	_wait->setChecked(_entryData->_wait);
 	_abortActiveFade->setChecked(_entryData->_abortActiveFade);
 	_fadeTypes->setCurrentIndex(static_cast<int>(_entryData->_fadeType));
+	_fadeCurves->setCurrentIndex(_fadeCurves->findData(
+		static_cast<int>(_entryData->_fadeCurve)));
 	SetWidgetVisibility();
 }
 
@@ -625,4 +619,15 @@ void MacroActionAudioEdit::FadeTypeChanged(int value)
 	SetWidgetVisibility();
 }
 
+void MacroActionAudioEdit::FadeCurveChanged(int idx)
+{
+	if (_loading || !_entryData) {
+		return;
+	}
+
+	auto lock = LockContext();
+	_entryData->_fadeCurve =
+		static_cast<FadeCurve>(_fadeCurves->itemData(idx).toInt());
+}
+
 } // namespace advss
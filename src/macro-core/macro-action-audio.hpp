@@ -1,6 +1,7 @@
 #pragma once
 #include "macro-action-edit.hpp"
 #include "duration-control.hpp"
+#include "fade-scheduler.hpp"
 #include "slider-spinbox.hpp"
 #include "source-selection.hpp"
 
@@ -53,15 +54,14 @@ public:
 	NumberVariable<double> _rate = 100.;
 	bool _wait = false;
 	bool _abortActiveFade = false;
+	FadeCurve _fadeCurve = FadeCurve::LINEAR;
 
 private:
 	void StartFade();
-	void FadeVolume();
 	void SetVolume(float vol);
 	float GetVolume();
-	void SetFadeActive(bool value);
-	bool FadeActive();
-	std::atomic_int *GetFadeIdPtr();
+	std::string GetFadeKey() const;
+	std::chrono::milliseconds GetFadeDuration(float from, float to) const;
 
 	static bool _registered;
 	static const std::string id;
@@ -96,6 +96,7 @@ private slots:
 	void WaitChanged(int value);
 	void AbortActiveFadeChanged(int value);
 	void FadeTypeChanged(int value);
+	void FadeCurveChanged(int value);
 signals:
 	void HeaderInfoChanged(const QString &);
 
@@ -103,6 +104,7 @@ protected:
 	SourceSelectionWidget *_sources;
 	QComboBox *_actions;
 	QComboBox *_fadeTypes;
+	QComboBox *_fadeCurves;
 	VariableSpinBox *_syncOffset;
 	QComboBox *_monitorTypes;
 	SliderSpinBox *_balance;
@@ -92,8 +92,6 @@ MacroActionEdit::MacroActionEdit(QWidget *parent,
 			 SLOT(ActionEnableChanged(bool)));
 	QWidget::connect(window(), SIGNAL(HighlightActionsChanged(bool)), this,
 			 SLOT(EnableHighlight(bool)));
-	QWidget::connect(&_actionStateTimer, SIGNAL(timeout()), this,
-			 SLOT(UpdateActionState()));
 
 	populateActionSelection(_actionSelection);
 
@@ -114,8 +112,6 @@ MacroActionEdit::MacroActionEdit(QWidget *parent,
 
 	_entryData = entryData;
 	UpdateEntryData(id);
-
-	_actionStateTimer.start(300);
 	_loading = false;
 }
 
@@ -139,11 +135,17 @@ void MacroActionEdit::ActionSelectionChanged(const QString &text)
 		*_entryData = MacroActionFactory::Create(id, macro);
 		(*_entryData)->SetIndex(idx);
 	}
-	auto widget = MacroActionFactory::CreateWidget(id, this, *_entryData);
+	_section->SetContent(CreateActionWidget());
+}
+
+QWidget *MacroActionEdit::CreateActionWidget()
+{
+	auto widget = MacroActionFactory::CreateWidget((*_entryData)->GetId(),
+						       this, *_entryData);
 	QWidget::connect(widget, SIGNAL(HeaderInfoChanged(const QString &)),
 			 this, SLOT(HeaderInfoChanged(const QString &)));
-	_section->SetContent(widget);
 	SetFocusPolicyOfWidgets();
+	return widget;
 }
 
 void MacroActionEdit::UpdateEntryData(const std::string &id)
@@ -153,13 +155,12 @@ void MacroActionEdit::UpdateEntryData(const std::string &id)
 	const bool enabled = (*_entryData)->Enabled();
 	_enable->setChecked(enabled);
 	SetDisableEffect(!enabled);
-	auto widget = MacroActionFactory::CreateWidget(id, this, *_entryData);
-	QWidget::connect(widget, SIGNAL(HeaderInfoChanged(const QString &)),
-			 this, SLOT(HeaderInfoChanged(const QString &)));
 	HeaderInfoChanged(
 		QString::fromStdString((*_entryData)->GetShortDesc()));
-	_section->SetContent(widget, (*_entryData)->GetCollapsed());
-	SetFocusPolicyOfWidgets();
+	// The action widget is only created once it is expanded or scrolled
+	// into view
+	_section->SetContent([this]() { return CreateActionWidget(); },
+			     (*_entryData)->GetCollapsed());
 }
 
 void MacroActionEdit::SetEntryData(std::shared_ptr<MacroAction> *data)
@@ -189,7 +190,7 @@ void MacroActionEdit::ActionEnableChanged(bool value)
 	SetDisableEffect(!value);
 }
 
-void MacroActionEdit::UpdateActionState()
+void MacroActionEdit::UpdateState()
 {
 	if (_loading || !_entryData) {
 		return;
@@ -200,6 +201,9 @@ void MacroActionEdit::UpdateActionState()
 
 void MacroActionEdit::SetEnableAppearance(bool value)
 {
+	if (_enable->isChecked() == value) {
+		return;
+	}
 	_enable->setChecked(value);
 	SetDisableEffect(!value);
 }
@@ -282,7 +286,7 @@ void AdvSceneSwitcher::RemoveMacroAction(int idx)
 		actionsList->Remove(idx);
 		macro->Actions().erase(macro->Actions().begin() + idx);
 		switcher->abortMacroWait = true;
-		switcher->macroWaitCv.notify_all();
+		InterruptMacroWaits();
 		macro->UpdateActionIndices();
 		SetActionData(*macro);
 	}
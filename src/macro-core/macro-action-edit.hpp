@@ -47,10 +47,11 @@ public:
 private slots:
 	void ActionSelectionChanged(const QString &text);
 	void ActionEnableChanged(bool);
-	void UpdateActionState();
 
 private:
 	std::shared_ptr<MacroSegment> Data();
+	void UpdateState() override;
+	QWidget *CreateActionWidget();
 	void SetDisableEffect(bool);
 	void SetEnableAppearance(bool);
 
@@ -58,7 +59,6 @@ private:
 	SwitchButton *_enable;
 
 	std::shared_ptr<MacroAction> *_entryData;
-	QTimer _actionStateTimer;
 	bool _loading = true;
 };
 
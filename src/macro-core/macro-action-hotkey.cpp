@@ -1,5 +1,5 @@
 #include "macro-action-hotkey.hpp"
-#include "platform-funcs.hpp"
+#include "key-press-queue.hpp"
 #include "utility.hpp"
 
 #include <obs-interaction.h>
@@ -202,20 +202,6 @@ keysToOBSKeycombo(const std::vector<HotkeyType> &keys)
 	return combo;
 }
 
-static void InjectKeys(const std::vector<HotkeyType> &keys, int duration)
-{
-	auto combo = keysToOBSKeycombo(keys);
-	if (obs_key_combination_is_empty(combo)) {
-		return;
-	}
-	// I am not sure why this is necessary
-	obs_hotkey_inject_event(combo, false);
-
-	obs_hotkey_inject_event(combo, true);
-	std::this_thread::sleep_for(std::chrono::milliseconds(duration));
-	obs_hotkey_inject_event(combo, false);
-}
-
 static void addNamePrefix(std::string &name, obs_hotkey_t *hotkey)
 {
 	const auto type = obs_hotkey_get_registerer_type(hotkey);
@@ -333,13 +319,15 @@ void MacroActionHotkey::SendCustomHotkey()
 	}
 
 	if (!keys.empty()) {
-		int dur = _duration.Milliseconds();
+		const std::chrono::milliseconds duration(
+			_duration.Milliseconds());
 		if (_onlySendToObs || !canSimulateKeyPresses) {
-			std::thread t([keys, dur]() { InjectKeys(keys, dur); });
-			t.detach();
+			auto combo = keysToOBSKeycombo(keys);
+			if (!obs_key_combination_is_empty(combo)) {
+				KeyPressQueue::Inject(combo, duration);
+			}
 		} else {
-			std::thread t([keys, dur]() { PressKeys(keys, dur); });
-			t.detach();
+			KeyPressQueue::Press(keys, duration);
 		}
 	}
 }
@@ -1,7 +1,6 @@
 #include "macro-action-osc.hpp"
 #include "utility.hpp"
 
-#include <system_error>
 #include <QGroupBox>
 
 namespace advss {
@@ -12,143 +11,46 @@ bool MacroActionOSC::_registered = MacroActionFactory::Register(
 	MacroActionOSC::id, {MacroActionOSC::Create, MacroActionOSCEdit::Create,
 			     "AdvSceneSwitcher.action.osc"});
 
-MacroActionOSC::MacroActionOSC(Macro *m)
-	: MacroAction(m),
-	  _ctx(asio::io_context()),
-	  _tcpSocket(asio::ip::tcp::socket(_ctx)),
-	  _udpSocket(asio::ip::udp::socket(_ctx))
+static OSCTransport::Protocol
+getTransportProtocol(MacroActionOSC::Protocol protocol)
 {
+	return protocol == MacroActionOSC::Protocol::TCP
+		       ? OSCTransport::Protocol::TCP
+		       : OSCTransport::Protocol::UDP;
 }
 
-void MacroActionOSC::SendOSCTCPMessage(const asio::mutable_buffer &buffer)
+void MacroActionOSC::UpdateTransport()
 {
-	try {
-		asio::write(_tcpSocket, asio::buffer(buffer));
-	} catch (const std::exception &e) {
-		blog(LOG_WARNING,
-		     "failed to send OSC message \"%s\" via TCP %s %d: %s",
-		     _message.ToString().c_str(), _ip.c_str(), _port.GetValue(),
-		     e.what());
-	}
-}
-
-void MacroActionOSC::SendOSCUDPMessage(const asio::mutable_buffer &buffer)
-{
-	try {
-		_udpSocket.send_to(buffer, _updEndpoint);
-	} catch (const std::exception &e) {
-		blog(LOG_WARNING,
-		     "failed to send OSC message \"%s\" via UDP %s %d: %s",
-		     _message.ToString().c_str(), _ip.c_str(), _port.GetValue(),
-		     e.what());
-	}
-}
-
-void MacroActionOSC::UDPReconnect()
-{
-	asio::error_code ec;
-	asio::ip::udp::resolver resolver(_ctx);
-	auto endpoints = resolver.resolve(asio::ip::udp::v4(), _ip.c_str(),
-					  std::to_string(_port.GetValue()), ec);
-	if (ec) {
-		endpoints = resolver.resolve(asio::ip::udp::v6(), _ip.c_str(),
-					     std::to_string(_port.GetValue()),
-					     ec);
-	}
-	if (ec) {
-		blog(LOG_WARNING, "failed to get IP for \"%s\": %s",
-		     _ip.c_str(), ec.message().c_str());
+	const auto protocol = getTransportProtocol(_protocol);
+	const char *ip = _ip.c_str();
+	const int port = _port.GetValue();
+	if (_transport && _transport->Matches(protocol, ip, port)) {
 		return;
 	}
-
-	try {
-		_updEndpoint = endpoints.begin()->endpoint();
-		_udpSocket = asio::ip::udp::socket(_ctx);
-		_udpSocket.open(endpoints.begin()->endpoint().protocol());
-	} catch (const std::exception &e) {
-		blog(LOG_WARNING, "failed to connect to UDP %s %d: %s",
-		     _ip.c_str(), _port.GetValue(), e.what());
-	}
-}
-
-void MacroActionOSC::TCPReconnect()
-{
-	asio::error_code ec;
-	asio::ip::tcp::resolver resolver(_ctx);
-	auto endpoints = resolver.resolve(asio::ip::tcp::v4(), _ip.c_str(),
-					  std::to_string(_port.GetValue()), ec);
-	if (ec) {
-		endpoints = resolver.resolve(asio::ip::tcp::v6(), _ip.c_str(),
-					     std::to_string(_port.GetValue()),
-					     ec);
-	}
-	if (ec) {
-		blog(LOG_WARNING, "failed to get IP for \"%s\": %s",
-		     _ip.c_str(), ec.message().c_str());
-		return;
-	}
-	try {
-		_tcpSocket = asio::ip::tcp::socket(_ctx);
-		_tcpSocket.connect(endpoints.begin()->endpoint());
-	} catch (const std::exception &e) {
-		blog(LOG_WARNING, "failed to connect to TCP %s %d: %s",
-		     _ip.c_str(), _port.GetValue(), e.what());
-	}
-}
-
-void MacroActionOSC::CheckReconnect()
-{
-	if (_protocol == Protocol::TCP &&
-	    (_reconnect || !_tcpSocket.is_open())) {
-		TCPReconnect();
-	}
-
-	if (_protocol == Protocol::UDP &&
-	    (_reconnect || !_udpSocket.is_open())) {
-		UDPReconnect();
-	}
+	_transport = OSCTransport::Get(protocol, ip, port);
 }
 
 bool MacroActionOSC::PerformAction()
 {
-	auto buffer = _message.GetBuffer();
-	if (!buffer.has_value()) {
+	auto buffer = _message.GetCachedBuffer();
+	if (!buffer) {
 		blog(LOG_WARNING, "failed to create or fill OSC buffer!");
 		return true;
 	}
 
-	CheckReconnect();
-
-	if (_protocol == Protocol::TCP &&
-	    (_reconnect || !_tcpSocket.is_open())) {
-		TCPReconnect();
-	}
-
-	if (_protocol == Protocol::UDP &&
-	    (_reconnect || !_udpSocket.is_open())) {
-		UDPReconnect();
-	}
-
-	auto rawMessage = asio::buffer(*buffer);
-
-	switch (_protocol) {
-	case MacroActionOSC::Protocol::TCP:
-		SendOSCTCPMessage(rawMessage);
-		break;
-	case MacroActionOSC::Protocol::UDP:
-		SendOSCUDPMessage(rawMessage);
-		break;
-	default:
-		break;
+	UpdateTransport();
+	if (_bundle) {
+		_transport->AddToBundle(*buffer);
+	} else {
+		_transport->Send(*buffer);
 	}
-
 	return true;
 }
 
 void MacroActionOSC::LogAction() const
 {
-	vblog(LOG_INFO, "sending OSC message '%s' to %s %s %d",
-	      _message.ToString().c_str(),
+	vblog(LOG_INFO, "%s OSC message '%s' to %s %s %d",
+	      _bundle ? "bundling" : "sending", _message.ToString().c_str(),
 	      _protocol == Protocol::UDP ? "UDP" : "TCP", _ip.c_str(),
 	      _port.GetValue());
 }
@@ -160,6 +62,7 @@ bool MacroActionOSC::Save(obs_data_t *obj) const
 	_ip.Save(obj, "ip");
 	_port.Save(obj, "port");
 	_message.Save(obj);
+	obs_data_set_bool(obj, "bundle", _bundle);
 	return true;
 }
 
@@ -170,25 +73,24 @@ bool MacroActionOSC::Load(obs_data_t *obj)
 	_ip.Load(obj, "ip");
 	_port.Load(obj, "port");
 	_message.Load(obj);
+	_bundle = obs_data_get_bool(obj, "bundle");
+	_transport.reset();
 	return true;
 }
 
 void MacroActionOSC::SetProtocol(Protocol p)
 {
 	_protocol = p;
-	_reconnect = true;
 }
 
 void MacroActionOSC::SetIP(const std::string &ip)
 {
 	_ip = ip;
-	_reconnect = true;
 }
 
 void MacroActionOSC::SetPortNr(IntVariable port)
 {
 	_port = port;
-	_reconnect = true;
 }
 
 static void populateProtocolSelection(QComboBox *list)
@@ -203,7 +105,9 @@ MacroActionOSCEdit::MacroActionOSCEdit(
 	  _protocol(new QComboBox(this)),
 	  _ip(new VariableLineEdit(this)),
 	  _port(new VariableSpinBox(this)),
-	  _message(new OSCMessageEdit(this))
+	  _message(new OSCMessageEdit(this)),
+	  _bundle(new QCheckBox(
+		  obs_module_text("AdvSceneSwitcher.action.osc.bundle")))
 {
 	populateProtocolSelection(_protocol);
 	_port->setMaximum(65535);
@@ -235,10 +139,13 @@ MacroActionOSCEdit::MacroActionOSCEdit(
 	auto messageLayout = new QHBoxLayout();
 	messageLayout->addWidget(_message);
 	messageGroup->setLayout(messageLayout);
+	_bundle->setToolTip(
+		obs_module_text("AdvSceneSwitcher.action.osc.bundle.tooltip"));
 
 	auto mainLayout = new QVBoxLayout;
 	mainLayout->addWidget(networkGroup);
 	mainLayout->addWidget(messageGroup);
+	mainLayout->addWidget(_bundle);
 	setLayout(mainLayout);
 
 	QWidget::connect(_ip, SIGNAL(editingFinished()), this,
@@ -251,6 +158,8 @@ MacroActionOSCEdit::MacroActionOSCEdit(
 		this, SLOT(PortChanged(const NumberVariable<int> &)));
 	QWidget::connect(_message, SIGNAL(MessageChanged(const OSCMessage &)),
 			 this, SLOT(MessageChanged(const OSCMessage &)));
+	QWidget::connect(_bundle, SIGNAL(stateChanged(int)), this,
+			 SLOT(BundleChanged(int)));
 
 	_entryData = entryData;
 	UpdateEntryData();
@@ -267,6 +176,7 @@ void MacroActionOSCEdit::UpdateEntryData()
 	_ip->setText(_entryData->GetIP());
 	_port->SetValue(_entryData->GetPortNr());
 	_message->SetMessage(_entryData->_message);
+	_bundle->setChecked(_entryData->_bundle);
 
 	adjustSize();
 	updateGeometry();
@@ -315,4 +225,14 @@ void MacroActionOSCEdit::MessageChanged(const OSCMessage &m)
 	updateGeometry();
 }
 
+void MacroActionOSCEdit::BundleChanged(int value)
+{
+	if (_loading || !_entryData) {
+		return;
+	}
+
+	auto lock = LockContext();
+	_entryData->_bundle = value;
+}
+
 } // namespace advss
@@ -1,15 +1,16 @@
 #pragma once
 #include "macro-action-edit.hpp"
 #include "osc-helpers.hpp"
+#include "osc-transport.hpp"
 
 #include <memory>
-#include <asio.hpp>
+#include <QCheckBox>
 
 namespace advss {
 
 class MacroActionOSC : public MacroAction {
 public:
-	MacroActionOSC(Macro *m);
+	MacroActionOSC(Macro *m) : MacroAction(m) {}
 	bool PerformAction();
 	void LogAction() const;
 	bool Save(obs_data_t *obj) const;
@@ -33,24 +34,16 @@ public:
 	IntVariable GetPortNr() { return _port; }
 
 	OSCMessage _message;
+	bool _bundle = false;
 
 private:
-	void SendOSCTCPMessage(const asio::mutable_buffer &);
-	void SendOSCUDPMessage(const asio::mutable_buffer &);
-
-	void CheckReconnect();
-	void TCPReconnect();
-	void UDPReconnect();
+	void UpdateTransport();
 
 	Protocol _protocol = Protocol::UDP;
 	StringVariable _ip = "localhost";
 	IntVariable _port = 12345;
-	bool _reconnect = true;
 
-	asio::io_context _ctx;
-	asio::ip::tcp::socket _tcpSocket;
-	asio::ip::udp::socket _udpSocket;
-	asio::ip::udp::endpoint _updEndpoint;
+	std::shared_ptr<OSCTransport> _transport;
 
 	static bool _registered;
 	static const std::string id;
@@ -76,6 +69,7 @@ private slots:
 	void MessageChanged(const OSCMessage &);
 	void ProtocolChanged(int);
 	void PortChanged(const NumberVariable<int> &value);
+	void BundleChanged(int);
 
 signals:
 	void HeaderInfoChanged(const QString &);
@@ -88,6 +82,7 @@ private:
 	VariableLineEdit *_ip;
 	VariableSpinBox *_port;
 	OSCMessageEdit *_message;
+	QCheckBox *_bundle;
 	bool _loading = true;
 };
 
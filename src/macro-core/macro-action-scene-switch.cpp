@@ -1,6 +1,7 @@
 #include "macro-action-scene-switch.hpp"
 #include "switcher-data.hpp"
 #include "scene-switch-helpers.hpp"
+#include "task-executor.hpp"
 #include "utility.hpp"
 
 namespace advss {
@@ -112,6 +113,7 @@ bool MacroActionSwitchScene::WaitForTransition(OBSWeakSource &scene,
 		scene, transition, _duration.Seconds());
 	switcher->abortMacroWait = false;
 
+	TaskExecutor::BlockingScope blocking;
 	std::unique_lock<std::mutex> lock(switcher->m);
 	if (expectedTransitionDuration < 0) {
 		waitForTransitionChange(transition, &lock, GetMacro());
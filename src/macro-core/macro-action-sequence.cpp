@@ -133,9 +133,9 @@ MacroActionSequenceEdit::MacroActionSequenceEdit(
 	setLayout(mainLayout);
 
 	UpdateStatusLine();
-	connect(&_statusTimer, SIGNAL(timeout()), this,
-		SLOT(UpdateStatusLine()));
-	_statusTimer.start(1000);
+	RegisterUIRefresh(this, [this](const UIRefreshSnapshot &) {
+		UpdateStatusLine();
+	});
 
 	_entryData = entryData;
 	UpdateEntryData();
@@ -1,11 +1,11 @@
 #pragma once
 #include "macro-action-edit.hpp"
 #include "macro-list.hpp"
+#include "ui-refresh.hpp"
 
 #include <QPushButton>
 #include <QListWidget>
 #include <QCheckBox>
-#include <QTimer>
 
 namespace advss {
 
@@ -69,7 +69,6 @@ private:
 	QPushButton *_continueFrom;
 	QCheckBox *_restart;
 	QLabel *_statusLine;
-	QTimer _statusTimer;
 	bool _loading = true;
 };
 
@@ -512,9 +512,12 @@ MacroActionVariableEdit::MacroActionVariableEdit(
 	_loading = false;
 
 	UpdateSegmentVariableValue();
-	connect(&_timer, SIGNAL(timeout()), this,
-		SLOT(UpdateSegmentVariableValue()));
-	_timer.start(1500);
+	RegisterUIRefresh(
+		this,
+		[this](const UIRefreshSnapshot &) {
+			UpdateSegmentVariableValue();
+		},
+		std::chrono::milliseconds(1500));
 }
 
 void MacroActionVariableEdit::UpdateEntryData()
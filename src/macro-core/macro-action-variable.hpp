@@ -3,6 +3,7 @@
 #include "macro-segment-selection.hpp"
 #include "regex-config.hpp"
 #include "resizing-text-edit.hpp"
+#include "ui-refresh.hpp"
 #include "variable-line-edit.hpp"
 
 namespace advss {
@@ -142,7 +143,6 @@ private:
 	void SetWidgetVisibility();
 	void SetSegmentValueError(const QString &);
 
-	QTimer _timer;
 	bool _loading = true;
 };
 
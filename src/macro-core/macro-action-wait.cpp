@@ -21,17 +21,6 @@ const static std::map<WaitType, std::string> waitTypes = {
 static std::random_device rd;
 static std::default_random_engine re(rd());
 
-static void waitHelper(std::unique_lock<std::mutex> *lock, Macro *macro,
-		       std::chrono::high_resolution_clock::time_point &time)
-{
-	while (!switcher->abortMacroWait && !macro->GetStop()) {
-		if (switcher->macroWaitCv.wait_until(*lock, time) ==
-		    std::cv_status::timeout) {
-			break;
-		}
-	}
-}
-
 bool MacroActionWait::PerformAction()
 {
 	double sleepDuration;
@@ -50,12 +39,20 @@ bool MacroActionWait::PerformAction()
 	vblog(LOG_INFO, "perform action wait with duration of %f",
 	      sleepDuration);
 
-	auto time = std::chrono::high_resolution_clock::now() +
+	auto time = std::chrono::steady_clock::now() +
 		    std::chrono::milliseconds((int)(sleepDuration * 1000));
 
 	switcher->abortMacroWait = false;
-	std::unique_lock<std::mutex> lock(switcher->m);
-	waitHelper(&lock, GetMacro(), time);
+	auto macro = GetMacro();
+	if (macro->CanSuspend()) {
+		macro->SuspendUntil(time);
+		// Waits might have been aborted before the run was suspended
+		if (switcher->abortMacroWait) {
+			macro->Resume(false);
+		}
+		return true;
+	}
+	macro->WaitUntil(time);
 
 	return !switcher->abortMacroWait;
 }
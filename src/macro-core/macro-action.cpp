@@ -1,4 +1,5 @@
 #include "macro-action.hpp"
+#include "macro.hpp"
 
 namespace advss {
 
@@ -31,6 +32,10 @@ void MacroAction::LogAction() const
 void MacroAction::SetEnabled(bool value)
 {
 	_enabled = value;
+	// Actions can be enabled and disabled by other macros
+	if (auto macro = GetMacro()) {
+		macro->SetModified();
+	}
 }
 
 bool MacroAction::Enabled() const
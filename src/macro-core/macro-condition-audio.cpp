@@ -1,6 +1,7 @@
 #include "macro-condition-audio.hpp"
 #include "macro.hpp"
 #include "utility.hpp"
+#include "switcher-data.hpp"
 
 namespace advss {
 
@@ -33,6 +34,20 @@ const static std::map<MacroConditionAudio::OutputCondition, std::string>
 		 "AdvSceneSwitcher.condition.audio.state.below"},
 };
 
+const static std::map<MacroConditionAudio::OutputMeasurement, std::string>
+	audioOutputMeasurements = {
+		{MacroConditionAudio::OutputMeasurement::PEAK_SINCE_LAST_CHECK,
+		 "AdvSceneSwitcher.condition.audio.measurement.peakSinceLastCheck"},
+		{MacroConditionAudio::OutputMeasurement::PEAK,
+		 "AdvSceneSwitcher.condition.audio.measurement.peak"},
+		{MacroConditionAudio::OutputMeasurement::RMS,
+		 "AdvSceneSwitcher.condition.audio.measurement.rms"},
+		{MacroConditionAudio::OutputMeasurement::PERCENTILE,
+		 "AdvSceneSwitcher.condition.audio.measurement.percentile"},
+		{MacroConditionAudio::OutputMeasurement::TIME_RATIO,
+		 "AdvSceneSwitcher.condition.audio.measurement.timeRatio"},
+};
+
 const static std::map<MacroConditionAudio::VolumeCondition, std::string>
 	audioVolumeConditionTypes = {
 		{MacroConditionAudio::VolumeCondition::ABOVE,
@@ -47,41 +62,82 @@ const static std::map<MacroConditionAudio::VolumeCondition, std::string>
 		 "AdvSceneSwitcher.condition.audio.state.unmute"},
 };
 
-MacroConditionAudio::~MacroConditionAudio()
+// Levels will have a value from -60 db to 0 db
+static double dbToVolume(float db)
+{
+	return ((double)db + 60) * 1.7;
+}
+
+static float volumeToDb(double volume)
 {
-	obs_volmeter_remove_callback(_volmeter, SetVolumeLevel, this);
-	obs_volmeter_destroy(_volmeter);
+	return (float)(volume / 1.7 - 60);
+}
+
+double MacroConditionAudio::GetOutputVolume()
+{
+	const auto window = std::chrono::milliseconds(
+		static_cast<int64_t>(_window.Milliseconds()));
+
+	switch (_outputMeasurement) {
+	case OutputMeasurement::PEAK_SINCE_LAST_CHECK: {
+		// Ignore audio levels while the macro was paused or stopped
+		const auto macro = GetMacro();
+		if (macro && macro->MsSinceLastCheck() == 0) {
+			_audioLevel.ResetPeak(std::chrono::milliseconds(
+				GetSwitcher()->interval));
+		}
+		return dbToVolume(_audioLevel.GetPeakSinceLastRead());
+	}
+	case OutputMeasurement::PEAK:
+		return dbToVolume(_audioLevel.GetPeak(window));
+	case OutputMeasurement::RMS:
+		return dbToVolume(_audioLevel.GetRMS(window));
+	case OutputMeasurement::PERCENTILE:
+		return dbToVolume(
+			_audioLevel.GetPercentile(window, _percentage));
+	case OutputMeasurement::TIME_RATIO: {
+		const double ratioAbove = _audioLevel.GetRatioAbove(
+			window, volumeToDb(_volume));
+		const double ratio = _outputCondition == OutputCondition::ABOVE
+					     ? ratioAbove
+					     : 1. - ratioAbove;
+		return ratio * 100.;
+	}
+	default:
+		break;
+	}
+	return dbToVolume(-std::numeric_limits<float>::infinity());
 }
 
 bool MacroConditionAudio::CheckOutputCondition()
 {
 	bool ret = false;
-	auto s = obs_weak_source_get_source(_audioSource.GetSource());
+	if (_audioSource.GetType() == SourceSelection::Type::VARIABLE) {
+		ResetVolmeter();
+	}
 
-	double curVolume = ((double)_peak + 60) * 1.7;
+	const double curValue = GetOutputVolume();
+
+	// The ratio of time the volume was above or below the threshold has to
+	// reach the configured percentage
+	if (_outputMeasurement == OutputMeasurement::TIME_RATIO) {
+		ret = curValue >= _percentage;
+		SetVariableValue(std::to_string(curValue));
+		return ret;
+	}
 
 	switch (_outputCondition) {
 	case OutputCondition::ABOVE:
-		// peak will have a value from -60 db to 0 db
-		ret = curVolume > _volume;
+		ret = curValue > _volume;
 		break;
 	case OutputCondition::BELOW:
-		// peak will have a value from -60 db to 0 db
-		ret = curVolume < _volume;
+		ret = curValue < _volume;
 		break;
 	default:
 		break;
 	}
 
-	SetVariableValue(std::to_string(curVolume));
-
-	// Reset for next check
-	_peak = -std::numeric_limits<float>::infinity();
-	obs_source_release(s);
-	if (_audioSource.GetType() == SourceSelection::Type::VARIABLE) {
-		ResetVolmeter();
-	}
-
+	SetVariableValue(std::to_string(curValue));
 	return ret;
 }
 
@@ -215,27 +271,14 @@ bool MacroConditionAudio::Save(obs_data_t *obj) const
 			 static_cast<int>(_outputCondition));
 	obs_data_set_int(obj, "volumeCondition",
 			 static_cast<int>(_volumeCondition));
+	obs_data_set_int(obj, "outputMeasurement",
+			 static_cast<int>(_outputMeasurement));
+	_window.Save(obj, "window");
+	_percentage.Save(obj, "percentage");
 	obs_data_set_int(obj, "version", 1);
 	return true;
 }
 
-obs_volmeter_t *AddVolmeterToSource(MacroConditionAudio *entry,
-				    obs_weak_source *source)
-{
-	obs_volmeter_t *volmeter = obs_volmeter_create(OBS_FADER_LOG);
-	obs_volmeter_add_callback(volmeter, MacroConditionAudio::SetVolumeLevel,
-				  entry);
-	obs_source_t *as = obs_weak_source_get_source(source);
-	if (!obs_volmeter_attach_source(volmeter, as)) {
-		const char *name = obs_source_get_name(as);
-		blog(LOG_WARNING, "failed to attach volmeter to source %s",
-		     name);
-	}
-	obs_source_release(as);
-
-	return volmeter;
-}
-
 bool MacroConditionAudio::Load(obs_data_t *obj)
 {
 	MacroCondition::Load(obj);
@@ -256,7 +299,15 @@ bool MacroConditionAudio::Load(obs_data_t *obj)
 		obs_data_get_int(obj, "outputCondition"));
 	_volumeCondition = static_cast<VolumeCondition>(
 		obs_data_get_int(obj, "volumeCondition"));
-	_volmeter = AddVolmeterToSource(this, _audioSource.GetSource());
+	_outputMeasurement = static_cast<OutputMeasurement>(
+		obs_data_get_int(obj, "outputMeasurement"));
+	if (obs_data_has_user_value(obj, "window")) {
+		_window.Load(obj, "window");
+	}
+	if (obs_data_has_user_value(obj, "percentage")) {
+		_percentage.Load(obj, "percentage");
+	}
+	ResetVolmeter();
 	return true;
 }
 
@@ -265,29 +316,9 @@ std::string MacroConditionAudio::GetShortDesc() const
 	return _audioSource.ToString();
 }
 
-void MacroConditionAudio::SetVolumeLevel(void *data, const float *,
-					 const float peak[MAX_AUDIO_CHANNELS],
-					 const float *)
-{
-	MacroConditionAudio *c = static_cast<MacroConditionAudio *>(data);
-	const auto macro = c->GetMacro();
-	if (macro && macro->Paused()) {
-		return;
-	}
-
-	for (int i = 0; i < MAX_AUDIO_CHANNELS; i++) {
-		if (peak[i] > c->_peak) {
-			c->_peak = peak[i];
-		}
-	}
-}
-
 void MacroConditionAudio::ResetVolmeter()
 {
-	obs_volmeter_remove_callback(_volmeter, SetVolumeLevel, this);
-	obs_volmeter_destroy(_volmeter);
-
-	_volmeter = AddVolmeterToSource(this, _audioSource.GetSource());
+	_audioLevel.SetSource(_audioSource.GetSource());
 }
 
 static inline void populateCheckTypes(QComboBox *list)
@@ -314,6 +345,13 @@ static inline void populateOutputConditionSelection(QComboBox *list)
 	}
 }
 
+static inline void populateOutputMeasurementSelection(QComboBox *list)
+{
+	for (const auto &[_, name] : audioOutputMeasurements) {
+		list->addItem(obs_module_text(name.c_str()));
+	}
+}
+
 static inline void populateVolumeConditionSelection(QComboBox *list)
 {
 	list->clear();
@@ -331,7 +369,11 @@ MacroConditionAudioEdit::MacroConditionAudioEdit(
 	  _volume(new VariableSpinBox()),
 	  _syncOffset(new VariableSpinBox()),
 	  _monitorTypes(new QComboBox),
-	  _balance(new SliderSpinBox(0., 1., ""))
+	  _balance(new SliderSpinBox(0., 1., "")),
+	  _measurements(new QComboBox()),
+	  _percentage(new VariableDoubleSpinBox()),
+	  _window(new DurationSelection(this, false)),
+	  _measurementLayout(new QHBoxLayout())
 {
 	_volume->setSuffix("%");
 	_volume->setMaximum(100);
@@ -341,6 +383,15 @@ MacroConditionAudioEdit::MacroConditionAudioEdit(
 	_syncOffset->setMaximum(20000);
 	_syncOffset->setSuffix("ms");
 
+	_percentage->setMinimum(0.);
+	_percentage->setMaximum(100.);
+	_percentage->setSuffix("%");
+
+	// Older audio levels are no longer available
+	_window->SpinBox()->setMaximum(
+		std::chrono::duration<double>(AudioLevelReader::maxWindow)
+			.count());
+
 	auto sources = GetAudioSourceNames();
 	sources.sort();
 	_sources->SetSourceNameList(sources);
@@ -367,9 +418,18 @@ MacroConditionAudioEdit::MacroConditionAudioEdit(
 	QWidget::connect(_sources,
 			 SIGNAL(SourceChanged(const SourceSelection &)), this,
 			 SLOT(SourceChanged(const SourceSelection &)));
+	QWidget::connect(_measurements, SIGNAL(currentIndexChanged(int)), this,
+			 SLOT(MeasurementChanged(int)));
+	QWidget::connect(
+		_percentage,
+		SIGNAL(NumberVariableChanged(const NumberVariable<double> &)),
+		this, SLOT(PercentageChanged(const NumberVariable<double> &)));
+	QWidget::connect(_window, SIGNAL(DurationChanged(const Duration &)),
+			 this, SLOT(WindowChanged(const Duration &)));
 
 	populateCheckTypes(_checkTypes);
 	PopulateMonitorTypeSelection(_monitorTypes);
+	populateOutputMeasurementSelection(_measurements);
 
 	QHBoxLayout *switchLayout = new QHBoxLayout;
 	std::unordered_map<std::string, QWidget *> widgetPlaceholders = {
@@ -380,12 +440,20 @@ MacroConditionAudioEdit::MacroConditionAudioEdit(
 		{"{{monitorTypes}}", _monitorTypes},
 		{"{{balance}}", _balance},
 		{"{{condition}}", _condition},
+		{"{{measurement}}", _measurements},
+		{"{{percentage}}", _percentage},
+		{"{{window}}", _window},
 	};
 	PlaceWidgets(obs_module_text("AdvSceneSwitcher.condition.audio.entry"),
 		     switchLayout, widgetPlaceholders);
+	PlaceWidgets(
+		obs_module_text(
+			"AdvSceneSwitcher.condition.audio.entry.measurement"),
+		_measurementLayout, widgetPlaceholders);
 
 	QVBoxLayout *mainLayout = new QVBoxLayout;
 	mainLayout->addLayout(switchLayout);
+	mainLayout->addLayout(_measurementLayout);
 	mainLayout->addWidget(_balance);
 	setLayout(mainLayout);
 
@@ -472,6 +540,39 @@ void MacroConditionAudioEdit::BalanceChanged(const NumberVariable<double> &value
 	_entryData->_balance = value;
 }
 
+void MacroConditionAudioEdit::MeasurementChanged(int value)
+{
+	if (_loading || !_entryData) {
+		return;
+	}
+
+	auto lock = LockContext();
+	_entryData->_outputMeasurement =
+		static_cast<MacroConditionAudio::OutputMeasurement>(value);
+	SetWidgetVisibility();
+}
+
+void MacroConditionAudioEdit::PercentageChanged(
+	const NumberVariable<double> &value)
+{
+	if (_loading || !_entryData) {
+		return;
+	}
+
+	auto lock = LockContext();
+	_entryData->_percentage = value;
+}
+
+void MacroConditionAudioEdit::WindowChanged(const Duration &dur)
+{
+	if (_loading || !_entryData) {
+		return;
+	}
+
+	auto lock = LockContext();
+	_entryData->_window = dur;
+}
+
 void MacroConditionAudioEdit::ConditionChanged(int cond)
 {
 	if (_loading || !_entryData) {
@@ -526,6 +627,10 @@ void MacroConditionAudioEdit::UpdateEntryData()
 	_syncOffset->SetValue(_entryData->_syncOffset);
 	_monitorTypes->setCurrentIndex(_entryData->_monitorType);
 	_balance->SetDoubleValue(_entryData->_balance);
+	_measurements->setCurrentIndex(
+		static_cast<int>(_entryData->_outputMeasurement));
+	_percentage->SetValue(_entryData->_percentage);
+	_window->SetDuration(_entryData->_window);
 	_checkTypes->setCurrentIndex(_checkTypes->findData(
 		static_cast<int>(_entryData->_checkType)));
 
@@ -580,6 +685,20 @@ void MacroConditionAudioEdit::SetWidgetVisibility()
 			     MacroConditionAudio::Type::BALANCE);
 	_volMeter->setVisible(_entryData->_checkType ==
 			      MacroConditionAudio::Type::OUTPUT_VOLUME);
+	const bool isOutputCheck = _entryData->_checkType ==
+				   MacroConditionAudio::Type::OUTPUT_VOLUME;
+	const auto measurement = _entryData->_outputMeasurement;
+	SetLayoutVisible(_measurementLayout, isOutputCheck);
+	_window->setVisible(
+		isOutputCheck &&
+		measurement != MacroConditionAudio::OutputMeasurement::
+					       PEAK_SINCE_LAST_CHECK);
+	_percentage->setVisible(
+		isOutputCheck &&
+		(measurement ==
+			 MacroConditionAudio::OutputMeasurement::PERCENTILE ||
+		 measurement ==
+			 MacroConditionAudio::OutputMeasurement::TIME_RATIO));
 	adjustSize();
 }
 
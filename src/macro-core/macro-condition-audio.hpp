@@ -3,6 +3,8 @@
 #include "volume-control.hpp"
 #include "slider-spinbox.hpp"
 #include "source-selection.hpp"
+#include "volmeter-hub.hpp"
+#include "duration-control.hpp"
 
 #include <limits>
 #include <QWidget>
@@ -14,7 +16,6 @@ namespace advss {
 class MacroConditionAudio : public MacroCondition {
 public:
 	MacroConditionAudio(Macro *m) : MacroCondition(m, true) {}
-	~MacroConditionAudio();
 	bool CheckCondition();
 	bool Save(obs_data_t *obj) const;
 	bool Load(obs_data_t *obj);
@@ -24,10 +25,6 @@ public:
 	{
 		return std::make_shared<MacroConditionAudio>(m);
 	}
-	static void SetVolumeLevel(void *data,
-				   const float magnitude[MAX_AUDIO_CHANNELS],
-				   const float peak[MAX_AUDIO_CHANNELS],
-				   const float inputPeak[MAX_AUDIO_CHANNELS]);
 	void ResetVolmeter();
 
 	enum class Type {
@@ -43,6 +40,14 @@ public:
 		BELOW,
 	};
 
+	enum class OutputMeasurement {
+		PEAK_SINCE_LAST_CHECK,
+		PEAK,
+		RMS,
+		PERCENTILE,
+		TIME_RATIO,
+	};
+
 	enum class VolumeCondition {
 		ABOVE,
 		EXACT,
@@ -58,17 +63,21 @@ public:
 	NumberVariable<double> _balance = 0.5;
 	Type _checkType = Type::OUTPUT_VOLUME;
 	OutputCondition _outputCondition = OutputCondition::ABOVE;
+	OutputMeasurement _outputMeasurement =
+		OutputMeasurement::PEAK_SINCE_LAST_CHECK;
+	Duration _window = 1.0;
+	NumberVariable<double> _percentage = 90.0;
 	VolumeCondition _volumeCondition = VolumeCondition::ABOVE;
-	obs_volmeter_t *_volmeter = nullptr;
 
 private:
+	double GetOutputVolume();
 	bool CheckOutputCondition();
 	bool CheckVolumeCondition();
 	bool CheckSyncOffset();
 	bool CheckMonitor();
 	bool CheckBalance();
 
-	float _peak = -std::numeric_limits<float>::infinity();
+	AudioLevelReader _audioLevel;
 	static bool _registered;
 	static const std::string id;
 };
@@ -98,6 +107,9 @@ private slots:
 	void SyncOffsetChanged(const NumberVariable<int> &value);
 	void MonitorTypeChanged(int value);
 	void BalanceChanged(const NumberVariable<double> &value);
+	void MeasurementChanged(int);
+	void PercentageChanged(const NumberVariable<double> &value);
+	void WindowChanged(const Duration &);
 
 signals:
 	void HeaderInfoChanged(const QString &);
@@ -110,6 +122,10 @@ protected:
 	VariableSpinBox *_syncOffset;
 	QComboBox *_monitorTypes;
 	SliderSpinBox *_balance;
+	QComboBox *_measurements;
+	VariableDoubleSpinBox *_percentage;
+	DurationSelection *_window;
+	QHBoxLayout *_measurementLayout;
 	VolControl *_volMeter = nullptr;
 	std::shared_ptr<MacroConditionAudio> _entryData;
 
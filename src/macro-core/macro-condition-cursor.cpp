@@ -40,11 +40,11 @@ bool MacroConditionCursor::CheckClick()
 {
 	switch (_button) {
 	case MacroConditionCursor::Button::LEFT:
-		return _lastCheckTime < lastMouseLeftClickTime;
+		return _lastCheckTime < lastMouseLeftClickTime.load();
 	case MacroConditionCursor::Button::MIDDLE:
-		return _lastCheckTime < lastMouseMiddleClickTime;
+		return _lastCheckTime < lastMouseMiddleClickTime.load();
 	case MacroConditionCursor::Button::RIGHT:
-		return _lastCheckTime < lastMouseRightClickTime;
+		return _lastCheckTime < lastMouseRightClickTime.load();
 	}
 	return false;
 }
@@ -204,9 +204,9 @@ MacroConditionCursorEdit::MacroConditionCursorEdit(
 	mainLayout->addLayout(_curentPosLayout);
 	setLayout(mainLayout);
 
-	connect(&_timer, &QTimer::timeout, this,
-		&MacroConditionCursorEdit::UpdateCursorPos);
-	_timer.start(1000);
+	RegisterUIRefresh(this, [this](const UIRefreshSnapshot &snapshot) {
+		UpdateCursorPos(snapshot);
+	});
 
 	_entryData = entryData;
 	UpdateEntryData();
@@ -280,11 +280,11 @@ void MacroConditionCursorEdit::MaxYChanged(const NumberVariable<int> &pos)
 	SetupFrame();
 }
 
-void MacroConditionCursorEdit::UpdateCursorPos()
+void MacroConditionCursorEdit::UpdateCursorPos(
+	const UIRefreshSnapshot &snapshot)
 {
-	std::pair<int, int> position = GetCursorPos();
-	_xPos->setText(QString::number(position.first));
-	_yPos->setText(QString::number(position.second));
+	_xPos->setText(QString::number(snapshot.cursorPosition.first));
+	_yPos->setText(QString::number(snapshot.cursorPosition.second));
 }
 
 void MacroConditionCursorEdit::ToggleFrame()
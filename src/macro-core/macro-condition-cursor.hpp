@@ -2,11 +2,11 @@
 #include "macro-condition-edit.hpp"
 #include "striped-frame.hpp"
 #include "variable-spinbox.hpp"
+#include "ui-refresh.hpp"
 
 #include <QSpinBox>
 #include <QComboBox>
 #include <QPushButton>
-#include <QTimer>
 
 namespace advss {
 
@@ -69,7 +69,6 @@ private slots:
 	void MinYChanged(const NumberVariable<int> &pos);
 	void MaxXChanged(const NumberVariable<int> &pos);
 	void MaxYChanged(const NumberVariable<int> &pos);
-	void UpdateCursorPos();
 	void ToggleFrame();
 
 protected:
@@ -88,7 +87,7 @@ protected:
 private:
 	void SetWidgetVisibility();
 	void SetupFrame();
-	QTimer _timer;
+	void UpdateCursorPos(const UIRefreshSnapshot &);
 	StripedFrame _frame;
 	bool _loading = true;
 };
@@ -1,5 +1,6 @@
 #include "macro-condition-date.hpp"
 #include "macro.hpp"
+#include "deadline-scheduler.hpp"
 #include "utility.hpp"
 
 #include <QCalendarWidget>
@@ -173,6 +174,107 @@ bool MacroConditionDate::CheckRegularDate(int64_t msSinceLastCheck)
 	return match;
 }
 
+MacroConditionDate::~MacroConditionDate()
+{
+	DeadlineScheduler::Remove(this);
+}
+
+bool MacroConditionDate::ScheduleSettings::operator==(
+	const ScheduleSettings &other) const
+{
+	return dateTime == other.dateTime && dayOfWeek == other.dayOfWeek &&
+	       dayOfWeekCheck == other.dayOfWeekCheck &&
+	       ignoreDate == other.ignoreDate && repeat == other.repeat &&
+	       repeatSeconds == other.repeatSeconds;
+}
+
+bool MacroConditionDate::IsScheduled() const
+{
+	return _condition == Condition::AT && !_ignoreTime;
+}
+
+MacroConditionDate::ScheduleSettings
+MacroConditionDate::GetScheduleSettings() const
+{
+	ScheduleSettings settings;
+	settings.dateTime = _dateTime;
+	settings.dayOfWeek = _dayOfWeek;
+	settings.dayOfWeekCheck = _dayOfWeekCheck;
+	settings.ignoreDate = _ignoreDate;
+	settings.repeat = _repeat;
+	settings.repeatSeconds = _duration.Seconds();
+	return settings;
+}
+
+QDateTime MacroConditionDate::GetNextMatchAfter(const QDateTime &time) const
+{
+	if (_dayOfWeekCheck || _ignoreDate) {
+		// Matches once on every selected day
+		for (int i = 0; i <= 7; i++) {
+			const QDate date = time.date().addDays(i);
+			if (_dayOfWeekCheck && _dayOfWeek != Day::ANY &&
+			    date.dayOfWeek() != static_cast<int>(_dayOfWeek)) {
+				continue;
+			}
+			const QDateTime next(date, _dateTime.time());
+			if (next > time) {
+				return next;
+			}
+		}
+		return {};
+	}
+
+	if (_dateTime > time) {
+		return _dateTime;
+	}
+	const auto repeatMs = static_cast<qint64>(_duration.Seconds() * 1000);
+	if (!_repeat || repeatMs <= 0) {
+		return {};
+	}
+	// Skip the repetitions which were missed, e.g. as OBS was not running
+	const qint64 missed = _dateTime.msecsTo(time) / repeatMs + 1;
+	return _dateTime.addMSecs(missed * repeatMs);
+}
+
+bool MacroConditionDate::CheckSchedule(int64_t msSinceLastCheck)
+{
+	const QDateTime now = QDateTime::currentDateTime();
+	SetVariableValue(now.toString().toStdString());
+
+	const auto settings = GetScheduleSettings();
+	if (!_scheduled || !(settings == _scheduleSettings)) {
+		// Matches which were already covered by the previous check must
+		// not be reported again
+		const QDateTime from =
+			_lastCheck.isValid() ? _lastCheck
+					     : now.addMSecs(-msSinceLastCheck);
+		_nextMatch = GetNextMatchAfter(from);
+		_scheduleSettings = settings;
+		_scheduled = true;
+	}
+	_lastCheck = now;
+
+	const bool match = _nextMatch.isValid() && _nextMatch <= now;
+	if (match) {
+		if (_repeat && !_dayOfWeekCheck) {
+			const qint64 offset =
+				_dateTime.msecsTo(_nextMatch) +
+				static_cast<qint64>(_duration.Seconds() * 1000);
+			_dateTime = _dateTime.addMSecs(offset);
+			_dateTime2 = _dateTime2.addMSecs(offset);
+			_scheduleSettings.dateTime = _dateTime;
+		}
+		_nextMatch = GetNextMatchAfter(now);
+	}
+
+	if (_nextMatch.isValid()) {
+		DeadlineScheduler::Set(this, _nextMatch.toMSecsSinceEpoch());
+	} else {
+		DeadlineScheduler::Remove(this);
+	}
+	return match;
+}
+
 bool MacroConditionDate::CheckCondition()
 {
 	auto m = GetMacro();
@@ -180,6 +282,14 @@ bool MacroConditionDate::CheckCondition()
 		return false;
 	}
 	auto msSinceLastCheck = m->MsSinceLastCheck();
+	if (IsScheduled()) {
+		return CheckSchedule(msSinceLastCheck);
+	}
+	if (_scheduled) {
+		_scheduled = false;
+		_lastCheck = QDateTime();
+		DeadlineScheduler::Remove(this);
+	}
 	if (_dayOfWeekCheck) {
 		return CheckDayOfWeek(msSinceLastCheck);
 	}
@@ -461,11 +571,10 @@ MacroConditionDateEdit::MacroConditionDateEdit(
 	mainLayout->addLayout(_advancedToggleLayout);
 	setLayout(mainLayout);
 
-	QWidget::connect(&_timer, SIGNAL(timeout()), this,
-			 SLOT(ShowNextMatch()));
-	QWidget::connect(&_timer, SIGNAL(timeout()), this,
-			 SLOT(UpdateCurrentTime()));
-	_timer.start(1000);
+	RegisterUIRefresh(this, [this](const UIRefreshSnapshot &snapshot) {
+		ShowNextMatch();
+		UpdateCurrentTime(snapshot);
+	});
 
 	_entryData = entryData;
 	UpdateEntryData();
@@ -635,10 +744,10 @@ void MacroConditionDateEdit::PatternChanged()
 	_entryData->_pattern = _pattern->text().toStdString();
 }
 
-void MacroConditionDateEdit::UpdateCurrentTime()
+void MacroConditionDateEdit::UpdateCurrentTime(
+	const UIRefreshSnapshot &snapshot)
 {
-	QDateTime dateTime = dateTime.currentDateTime();
-	_currentDate->setText(dateTime.toString(dateFormat));
+	_currentDate->setText(snapshot.currentDateTime.toString(dateFormat));
 }
 
 void MacroConditionDateEdit::UpdateEntryData()
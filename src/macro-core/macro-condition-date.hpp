@@ -1,22 +1,24 @@
 #pragma once
 #include "macro-condition-edit.hpp"
 #include "duration-control.hpp"
+#include "ui-refresh.hpp"
 
 #include <QCheckBox>
 #include <QDateTimeEdit>
 #include <QComboBox>
-#include <QTimer>
 
 namespace advss {
 
 class MacroConditionDate : public MacroCondition {
 public:
 	MacroConditionDate(Macro *m) : MacroCondition(m, true) {}
+	~MacroConditionDate();
 	bool CheckCondition();
 	bool Save(obs_data_t *obj) const;
 	bool Load(obs_data_t *obj);
 	std::string GetShortDesc() const;
 	std::string GetId() const { return id; };
+	bool HasRuntimeSaveData() const { return _repeat && _updateOnRepeat; }
 	static std::shared_ptr<MacroCondition> Create(Macro *m)
 	{
 		return std::make_shared<MacroConditionDate>(m);
@@ -60,10 +62,26 @@ public:
 	std::string _pattern = ".... .. .. .. .. ..";
 
 private:
+	// Settings which the point in time of the next match depends on
+	struct ScheduleSettings {
+		QDateTime dateTime;
+		Day dayOfWeek = Day::ANY;
+		bool dayOfWeekCheck = true;
+		bool ignoreDate = false;
+		bool repeat = false;
+		double repeatSeconds = 0.;
+
+		bool operator==(const ScheduleSettings &) const;
+	};
+
 	bool CheckDayOfWeek(int64_t);
 	bool CheckRegularDate(int64_t);
 	bool CheckBetween(const QDateTime &now);
 	bool CheckPattern(QDateTime now, int64_t secondsSinceLastCheck);
+	bool IsScheduled() const;
+	bool CheckSchedule(int64_t msSinceLastCheck);
+	ScheduleSettings GetScheduleSettings() const;
+	QDateTime GetNextMatchAfter(const QDateTime &) const;
 
 	QDateTime _dateTime = QDateTime::currentDateTime();
 	QDateTime _dateTime2 = QDateTime::currentDateTime();
@@ -71,6 +89,14 @@ private:
 	QDateTime _origDateTime = QDateTime::currentDateTime();
 	QDateTime _origDateTime2 = QDateTime::currentDateTime();
 
+	// Conditions matching at a specific point in time only compute when
+	// they will match next once, instead of checking if the point in time
+	// was passed since the last check
+	bool _scheduled = false;
+	ScheduleSettings _scheduleSettings;
+	QDateTime _nextMatch;
+	QDateTime _lastCheck;
+
 	static bool _registered;
 	static const std::string id;
 };
@@ -105,7 +131,6 @@ private slots:
 	void DurationChanged(const Duration &seconds);
 	void AdvancedSettingsToggleClicked();
 	void ShowNextMatch();
-	void UpdateCurrentTime();
 	void PatternChanged();
 signals:
 	void HeaderInfoChanged(const QString &);
@@ -147,7 +172,7 @@ private:
 	void SetWidgetStatus();
 	void ShowFirstDateSelection(bool visible);
 	void ShowSecondDateSelection(bool visible);
-	QTimer _timer;
+	void UpdateCurrentTime(const UIRefreshSnapshot &);
 	bool _loading = true;
 };
 
@@ -269,14 +269,13 @@ void MacroConditionEdit::UpdateEntryData(const std::string &id)
 {
 	_conditionSelection->setCurrentText(obs_module_text(
 		MacroConditionFactory::GetConditionName(id).c_str()));
-	auto widget =
-		MacroConditionFactory::CreateWidget(id, this, *_entryData);
-	QWidget::connect(widget, SIGNAL(HeaderInfoChanged(const QString &)),
-			 this, SLOT(HeaderInfoChanged(const QString &)));
 	HeaderInfoChanged(
 		QString::fromStdString((*_entryData)->GetShortDesc()));
 	SetLogicSelection();
-	_section->SetContent(widget, (*_entryData)->GetCollapsed());
+	// The condition widget is only created once it is expanded or
+	// scrolled into view
+	_section->SetContent([this]() { return CreateConditionWidget(); },
+			     (*_entryData)->GetCollapsed());
 
 	_dur->setVisible(MacroConditionFactory::UsesDurationModifier(id));
 	auto modifier = (*_entryData)->GetDurationModifier();
@@ -284,6 +283,16 @@ void MacroConditionEdit::UpdateEntryData(const std::string &id)
 	SetFocusPolicyOfWidgets();
 }
 
+QWidget *MacroConditionEdit::CreateConditionWidget()
+{
+	auto widget = MacroConditionFactory::CreateWidget(
+		(*_entryData)->GetId(), this, *_entryData);
+	QWidget::connect(widget, SIGNAL(HeaderInfoChanged(const QString &)),
+			 this, SLOT(HeaderInfoChanged(const QString &)));
+	SetFocusPolicyOfWidgets();
+	return widget;
+}
+
 void MacroConditionEdit::SetEntryData(std::shared_ptr<MacroCondition> *data)
 {
 	_entryData = data;
@@ -313,13 +322,8 @@ void MacroConditionEdit::ConditionSelectionChanged(const QString &text)
 		(*_entryData)->SetIndex(idx);
 		(*_entryData)->SetLogicType(logic);
 	}
-	auto widget =
-		MacroConditionFactory::CreateWidget(id, this, *_entryData);
-	QWidget::connect(widget, SIGNAL(HeaderInfoChanged(const QString &)),
-			 this, SLOT(HeaderInfoChanged(const QString &)));
-	_section->SetContent(widget);
+	_section->SetContent(CreateConditionWidget());
 	_dur->setVisible(MacroConditionFactory::UsesDurationModifier(id));
-	SetFocusPolicyOfWidgets();
 }
 
 void MacroConditionEdit::DurationChanged(const Duration &seconds)
@@ -76,6 +76,7 @@ private slots:
 private:
 	void SetLogicSelection();
 	std::shared_ptr<MacroSegment> Data();
+	QWidget *CreateConditionWidget();
 
 	QComboBox *_logicSelection;
 	FilterComboBox *_conditionSelection;
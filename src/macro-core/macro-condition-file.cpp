@@ -5,6 +5,7 @@
 
 #include <QTextStream>
 #include <QFileDialog>
+#include <QStandardItemModel>
 #include <regex>
 
 namespace advss {
@@ -18,6 +19,10 @@ bool MacroConditionFile::_registered = MacroConditionFactory::Register(
 
 static std::hash<std::string> strHash;
 
+constexpr qint64 tailChunkSize = 64 * 1024;
+constexpr qint64 tailHeadSize = 256;
+constexpr int maxTailLineLength = 1024 * 1024;
+
 static size_t WriteCallback(void *contents, size_t size, size_t nmemb,
 			    void *userp)
 {
@@ -138,6 +143,108 @@ bool MacroConditionFile::CheckChangeDate()
 	return dateChanged;
 }
 
+void MacroConditionFile::ResetTail()
+{
+	_tailOffset = -1;
+	_tailHead.clear();
+	_tailPartialLine.clear();
+}
+
+bool MacroConditionFile::MatchNewLine(const QString &line,
+				      const QRegularExpression &expr)
+{
+	if (_regex.Enabled()) {
+		return expr.match(line).hasMatch();
+	}
+	return line == QString::fromStdString(_text);
+}
+
+bool MacroConditionFile::CheckNewLines()
+{
+	if (_fileType == FileType::REMOTE) {
+		return false;
+	}
+
+	std::string path = _file;
+	if (path != _tailPath) {
+		ResetTail();
+		_tailPath = path;
+	}
+
+	QFile file(QString::fromStdString(path));
+	if (!file.open(QIODevice::ReadOnly)) {
+		ResetTail();
+		return false;
+	}
+
+	// Only lines appended after the first check are of interest
+	const qint64 size = file.size();
+	if (_tailOffset < 0) {
+		_tailHead = file.peek(tailHeadSize);
+		_tailOffset = size;
+		return false;
+	}
+
+	// Start over from the beginning if the file was truncated or replaced
+	// by a new file with different content (e.g. log rotation)
+	const auto head = file.peek(tailHeadSize);
+	if (size < _tailOffset || !head.startsWith(_tailHead)) {
+		vblog(LOG_INFO, "file \"%s\" was truncated or rotated",
+		      path.c_str());
+		_tailOffset = 0;
+		_tailPartialLine.clear();
+	}
+	_tailHead = head;
+
+	if (size == _tailOffset || !file.seek(_tailOffset)) {
+		return false;
+	}
+
+	QRegularExpression expr;
+	if (_regex.Enabled()) {
+		expr = _regex.GetRegularExpression(_text);
+		if (!expr.isValid()) {
+			_tailOffset = size;
+			return false;
+		}
+	}
+
+	bool match = false;
+	while (!file.atEnd()) {
+		auto chunk = file.read(tailChunkSize);
+		if (chunk.isEmpty()) {
+			break;
+		}
+		_tailOffset += chunk.size();
+
+		int lineStart = 0;
+		int lineEnd = chunk.indexOf('\n');
+		while (lineEnd != -1) {
+			_tailPartialLine.append(chunk.constData() + lineStart,
+						lineEnd - lineStart);
+			if (_tailPartialLine.endsWith('\r')) {
+				_tailPartialLine.chop(1);
+			}
+			const auto line = QString::fromUtf8(_tailPartialLine);
+			if (MatchNewLine(line, expr)) {
+				SetVariableValue(line.toStdString());
+				match = true;
+			}
+			_tailPartialLine.clear();
+			lineStart = lineEnd + 1;
+			lineEnd = chunk.indexOf('\n', lineStart);
+		}
+		_tailPartialLine.append(chunk.constData() + lineStart,
+					chunk.size() - lineStart);
+
+		// Protect against files which never contain a line break
+		if (_tailPartialLine.size() > maxTailLineLength) {
+			_tailPartialLine.clear();
+		}
+	}
+	return match;
+}
+
 bool MacroConditionFile::CheckCondition()
 {
 	bool ret = false;
@@ -155,6 +262,9 @@ bool MacroConditionFile::CheckCondition()
 	case MacroConditionFile::ConditionType::DATE_CHANGE:
 		ret = CheckChangeDate();
 		break;
+	case MacroConditionFile::ConditionType::NEW_LINE_MATCH:
+		ret = CheckNewLines();
+		break;
 	default:
 		break;
 	}
@@ -218,6 +328,8 @@ static void populateConditions(QComboBox *list)
 		"AdvSceneSwitcher.condition.file.type.contentChange"));
 	list->addItem(obs_module_text(
 		"AdvSceneSwitcher.condition.file.type.dateChange"));
+	list->addItem(obs_module_text(
+		"AdvSceneSwitcher.condition.file.type.newLineMatch"));
 }
 
 MacroConditionFileEdit::MacroConditionFileEdit(
@@ -340,9 +452,17 @@ void MacroConditionFileEdit::ConditionChanged(int index)
 		return;
 	}
 
-	auto lock = LockContext();
-	_entryData->_condition =
-		static_cast<MacroConditionFile::ConditionType>(index);
+	{
+		auto lock = LockContext();
+		_entryData->_condition =
+			static_cast<MacroConditionFile::ConditionType>(index);
+	}
+	if (_entryData->_condition ==
+		    MacroConditionFile::ConditionType::NEW_LINE_MATCH &&
+	    _entryData->_fileType == MacroConditionFile::FileType::REMOTE) {
+		_fileTypes->setCurrentIndex(
+			static_cast<int>(MacroConditionFile::FileType::LOCAL));
+	}
 	SetWidgetVisibility();
 }
 
@@ -409,10 +529,13 @@ void MacroConditionFileEdit::SetWidgetVisibility()
 		return;
 	}
 
-	_matchText->setVisible(_entryData->_condition ==
-			       MacroConditionFile::ConditionType::MATCH);
-	_regex->setVisible(_entryData->_condition ==
-			   MacroConditionFile::ConditionType::MATCH);
+	const bool showMatchText =
+		_entryData->_condition ==
+			MacroConditionFile::ConditionType::MATCH ||
+		_entryData->_condition ==
+			MacroConditionFile::ConditionType::NEW_LINE_MATCH;
+	_matchText->setVisible(showMatchText);
+	_regex->setVisible(showMatchText);
 	_checkModificationDate->setVisible(
 		_entryData->_useTime &&
 		_entryData->_condition ==
@@ -421,6 +544,16 @@ void MacroConditionFileEdit::SetWidgetVisibility()
 		_entryData->_onlyMatchIfChanged &&
 		_entryData->_condition ==
 			MacroConditionFile::ConditionType::MATCH);
+
+	// Only local files can be checked for new lines
+	auto model = qobject_cast<QStandardItemModel *>(_fileTypes->model());
+	if (model) {
+		const int remoteIdx = static_cast<int>(
+			MacroConditionFile::FileType::REMOTE);
+		model->item(remoteIdx)->setEnabled(
+			_entryData->_condition !=
+			MacroConditionFile::ConditionType::NEW_LINE_MATCH);
+	}
 	adjustSize();
 	updateGeometry();
 }
@@ -35,6 +35,7 @@ public:
 		MATCH,
 		CONTENT_CHANGE,
 		DATE_CHANGE,
+		NEW_LINE_MATCH,
 	};
 
 	StringVariable _file = obs_module_text("AdvSceneSwitcher.enterPath");
@@ -53,9 +54,18 @@ private:
 	bool CheckLocalFileContent();
 	bool CheckChangeContent();
 	bool CheckChangeDate();
+	bool CheckNewLines();
+	bool MatchNewLine(const QString &line, const QRegularExpression &expr);
+	void ResetTail();
 
 	QDateTime _lastMod;
 	size_t _lastHash = 0;
+
+	// State used to only process lines appended since the last check
+	std::string _tailPath;
+	qint64 _tailOffset = -1;
+	QByteArray _tailHead;
+	QByteArray _tailPartialLine;
 	static bool _registered;
 	static const std::string id;
 };
@@ -306,14 +306,11 @@ MacroConditionMacroEdit::MacroConditionMacroEdit(
 
 	_entryData = entryData;
 
-	QWidget::connect(&_countTimer, SIGNAL(timeout()), this,
-			 SLOT(UpdateCount()));
-	_countTimer.start(1000);
-
 	_pausedWarning->setVisible(false);
-	QWidget::connect(&_pausedTimer, SIGNAL(timeout()), this,
-			 SLOT(UpdatePaused()));
-	_pausedTimer.start(1000);
+	RegisterUIRefresh(this, [this](const UIRefreshSnapshot &) {
+		UpdateCount();
+		UpdatePaused();
+	});
 
 	UpdateEntryData();
 	_loading = false;
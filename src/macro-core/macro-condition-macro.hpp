@@ -3,12 +3,12 @@
 #include "macro-selection.hpp"
 #include "macro-list.hpp"
 #include "macro-segment-selection.hpp"
+#include "ui-refresh.hpp"
 
 #include <QComboBox>
 #include <QSpinBox>
 #include <QPushButton>
 #include <QHBoxLayout>
-#include <QTimer>
 #include <QListWidget>
 
 namespace advss {
@@ -117,8 +117,6 @@ protected:
 	QComboBox *_multiStateConditions;
 	VariableSpinBox *_multiStateCount;
 	MacroSegmentSelection *_actionIndex;
-	QTimer _countTimer;
-	QTimer _pausedTimer;
 	std::shared_ptr<MacroConditionMacro> _entryData;
 
 private:
@@ -70,8 +70,6 @@ MacroConditionProcessEdit::MacroConditionProcessEdit(
 			 SLOT(ProcessChanged(const QString &)));
 	QWidget::connect(_focused, SIGNAL(stateChanged(int)), this,
 			 SLOT(FocusChanged(int)));
-	QWidget::connect(&_timer, SIGNAL(timeout()), this,
-			 SLOT(UpdateFocusProcess()));
 
 	PopulateProcessSelection(_processSelection);
 
@@ -97,7 +95,9 @@ MacroConditionProcessEdit::MacroConditionProcessEdit(
 	UpdateEntryData();
 	_loading = false;
 
-	_timer.start(1000);
+	RegisterUIRefresh(this, [this](const UIRefreshSnapshot &snapshot) {
+		UpdateFocusProcess(snapshot);
+	});
 }
 
 void MacroConditionProcessEdit::ProcessChanged(const QString &text)
@@ -123,10 +123,11 @@ void MacroConditionProcessEdit::FocusChanged(int state)
 	SetWidgetVisibility();
 }
 
-void MacroConditionProcessEdit::UpdateFocusProcess()
+void MacroConditionProcessEdit::UpdateFocusProcess(
+	const UIRefreshSnapshot &snapshot)
 {
 	_focusProcess->setText(
-		QString::fromStdString(switcher->currentForegroundProcess));
+		QString::fromStdString(snapshot.foregroundProcess));
 }
 
 void MacroConditionProcessEdit::SetWidgetVisibility()
@@ -1,5 +1,6 @@
 #pragma once
 #include "macro-condition-edit.hpp"
+#include "ui-refresh.hpp"
 
 #include <QComboBox>
 #include <QCheckBox>
@@ -46,7 +47,6 @@ public:
 private slots:
 	void ProcessChanged(const QString &text);
 	void FocusChanged(int state);
-	void UpdateFocusProcess();
 signals:
 	void HeaderInfoChanged(const QString &);
 
@@ -55,11 +55,11 @@ protected:
 	QCheckBox *_focused;
 	QLabel *_focusProcess;
 	QHBoxLayout *_focusLayout;
-	QTimer _timer;
 	std::shared_ptr<MacroConditionProcess> _entryData;
 
 private:
 	void SetWidgetVisibility();
+	void UpdateFocusProcess(const UIRefreshSnapshot &);
 
 	bool _loading = true;
 };
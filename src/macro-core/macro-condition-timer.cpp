@@ -1,6 +1,10 @@
 #include "macro-condition-timer.hpp"
+#include "deadline-scheduler.hpp"
 #include "utility.hpp"
 
+#include <cmath>
+#include <QDateTime>
+
 namespace advss {
 
 const std::string MacroConditionTimer::id = "timer";
@@ -15,13 +19,20 @@ const static std::map<TimerType, std::string> timerTypes = {
 	{TimerType::RANDOM, "AdvSceneSwitcher.condition.timer.type.random"},
 };
 
+MacroConditionTimer::~MacroConditionTimer()
+{
+	DeadlineScheduler::Remove(this);
+}
+
 bool MacroConditionTimer::CheckCondition()
 {
 	if (_paused) {
+		DeadlineScheduler::Remove(this);
 		SetVariableValue(std::to_string(_remaining));
 		return _remaining == 0.;
 	}
 	SetVariableValue(std::to_string(_duration.TimeRemaining()));
+	bool match = false;
 	if (_duration.DurationReached()) {
 		if (!_oneshot) {
 			_duration.Reset();
@@ -29,9 +40,24 @@ bool MacroConditionTimer::CheckCondition()
 				SetRandomTimeRemaining();
 			}
 		}
-		return true;
+		match = true;
+	}
+	ScheduleNextMatch();
+	return match;
+}
+
+void MacroConditionTimer::ScheduleNextMatch()
+{
+	const double remaining = _duration.TimeRemaining();
+	// Expired one shot timers will not match again until they are reset
+	if (remaining <= 0.) {
+		DeadlineScheduler::Remove(this);
+		return;
 	}
-	return false;
+	DeadlineScheduler::Set(this,
+			       QDateTime::currentMSecsSinceEpoch() +
+				       static_cast<int64_t>(
+					       std::ceil(remaining * 1000)));
 }
 
 void MacroConditionTimer::SetRandomTimeRemaining()
@@ -192,8 +218,9 @@ MacroConditionTimerEdit::MacroConditionTimerEdit(
 	UpdateEntryData();
 	_loading = false;
 
-	connect(&timer, SIGNAL(timeout()), this, SLOT(UpdateTimeRemaining()));
-	timer.start(1000);
+	RegisterUIRefresh(this, [this](const UIRefreshSnapshot &) {
+		UpdateTimeRemaining();
+	});
 }
 
 void MacroConditionTimerEdit::TimerTypeChanged(int type)
@@ -255,11 +282,9 @@ void MacroConditionTimerEdit::PauseContinueClicked()
 
 	auto lock = LockContext();
 	if (_entryData->_paused) {
-		timer.start(1000);
 		_entryData->Continue();
 	} else {
 		_entryData->Pause();
-		timer.stop();
 	}
 	SetPauseContinueButtonLabel();
 }
@@ -1,10 +1,10 @@
 #pragma once
 #include "macro-condition-edit.hpp"
 #include "duration-control.hpp"
+#include "ui-refresh.hpp"
 
 #include <QCheckBox>
 #include <QPushButton>
-#include <QTimer>
 #include <QComboBox>
 #include <QHBoxLayout>
 
@@ -20,10 +20,13 @@ enum class TimerType {
 class MacroConditionTimer : public MacroCondition {
 public:
 	MacroConditionTimer(Macro *m) : MacroCondition(m, true) {}
+	~MacroConditionTimer();
 	bool CheckCondition();
 	bool Save(obs_data_t *obj) const;
 	bool Load(obs_data_t *obj);
 	std::string GetId() const { return id; };
+	// The timer state can be modified by the timer action at any time
+	bool HasRuntimeSaveData() const { return true; }
 	static std::shared_ptr<MacroCondition> Create(Macro *m)
 	{
 		return std::make_shared<MacroConditionTimer>(m);
@@ -42,6 +45,7 @@ public:
 
 private:
 	void SetRandomTimeRemaining();
+	void ScheduleNextMatch();
 	std::default_random_engine _re;
 	static bool _registered;
 	static const std::string id;
@@ -90,7 +94,6 @@ private:
 	void SetWidgetVisibility();
 
 	QHBoxLayout *_timerLayout;
-	QTimer timer;
 	bool _loading = true;
 };
 
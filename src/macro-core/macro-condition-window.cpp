@@ -197,8 +197,6 @@ MacroConditionWindowEdit::MacroConditionWindowEdit(
 			 SLOT(WindowTextChanged()));
 	QWidget::connect(_textRegex, SIGNAL(RegexConfigChanged(RegexConfig)),
 			 this, SLOT(TextRegexChanged(RegexConfig)));
-	QWidget::connect(&_timer, SIGNAL(timeout()), this,
-			 SLOT(UpdateFocusWindow()));
 
 	PopulateWindowSelection(_windowSelection);
 
@@ -275,7 +273,9 @@ MacroConditionWindowEdit::MacroConditionWindowEdit(
 	UpdateEntryData();
 	_loading = false;
 
-	_timer.start(1000);
+	RegisterUIRefresh(this, [this](const UIRefreshSnapshot &snapshot) {
+		UpdateFocusWindow(snapshot);
+	});
 }
 
 void MacroConditionWindowEdit::WindowChanged(const QString &text)
@@ -398,9 +398,11 @@ void MacroConditionWindowEdit::WindowFocusChanged(int state)
 	SetWidgetVisibility();
 }
 
-void MacroConditionWindowEdit::UpdateFocusWindow()
+void MacroConditionWindowEdit::UpdateFocusWindow(
+	const UIRefreshSnapshot &snapshot)
 {
-	_focusWindow->setText(QString::fromStdString(switcher->currentTitle));
+	_focusWindow->setText(
+		QString::fromStdString(snapshot.foregroundWindowTitle));
 }
 
 void MacroConditionWindowEdit::SetWidgetVisibility()
@@ -2,6 +2,7 @@
 #include "macro-condition-edit.hpp"
 #include "variable-text-edit.hpp"
 #include "regex-config.hpp"
+#include "ui-refresh.hpp"
 
 #include <QComboBox>
 #include <QCheckBox>
@@ -71,7 +72,6 @@ private slots:
 	void CheckTextChanged(int state);
 	void WindowTextChanged();
 	void TextRegexChanged(RegexConfig);
-	void UpdateFocusWindow();
 signals:
 	void HeaderInfoChanged(const QString &);
 
@@ -88,11 +88,11 @@ protected:
 	RegexConfigWidget *_textRegex;
 	QLabel *_focusWindow;
 	QHBoxLayout *_currentFocusLayout;
-	QTimer _timer;
 	std::shared_ptr<MacroConditionWindow> _entryData;
 
 private:
 	void SetWidgetVisibility();
+	void UpdateFocusWindow(const UIRefreshSnapshot &);
 
 	bool _loading = true;
 };
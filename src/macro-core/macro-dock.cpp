@@ -47,9 +47,13 @@ MacroDock::MacroDock(Macro *m, QWidget *parent,
 	layout->addWidget(_statusText);
 
 	UpdateText();
-	QWidget::connect(&_timer, SIGNAL(timeout()), this, SLOT(UpdateText()));
-	QWidget::connect(&_timer, SIGNAL(timeout()), this, SLOT(Highlight()));
-	_timer.start(500);
+	RegisterUIRefresh(
+		this,
+		[this](const UIRefreshSnapshot &) {
+			UpdateText();
+			Highlight();
+		},
+		std::chrono::milliseconds(500));
 
 	// QFrame wrapper is necessary to avoid dock being partially
 	// transparent
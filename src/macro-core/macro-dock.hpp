@@ -1,9 +1,9 @@
 #pragma once
 #include "obs-dock.hpp"
 #include "variable-string.hpp"
+#include "ui-refresh.hpp"
 
 #include <QPushButton>
-#include <QTimer>
 #include <QLabel>
 #include <memory>
 #include <chrono>
@@ -50,7 +50,6 @@ private:
 	QPushButton *_pauseToggle;
 	QLabel *_statusText;
 
-	QTimer _timer;
 	std::chrono::high_resolution_clock::time_point _lastHighlightCheckTime{};
 
 	Macro *_macro;
@@ -15,6 +15,7 @@ void MacroProperties::Save(obs_data_t *obj) const
 	obs_data_set_bool(data, "highlightActions", _highlightActions);
 	obs_data_set_bool(data, "newMacroRegisterHotkey",
 			  _newMacroRegisterHotkeys);
+	obs_data_set_int(data, "maxParallelRuns", _maxParallelRuns);
 	obs_data_set_obj(obj, "macroProperties", data);
 	obs_data_release(data);
 }
@@ -27,6 +28,7 @@ void MacroProperties::Load(obs_data_t *obj)
 	_highlightActions = obs_data_get_bool(data, "highlightActions");
 	_newMacroRegisterHotkeys =
 		obs_data_get_bool(data, "newMacroRegisterHotkey");
+	_maxParallelRuns = obs_data_get_int(data, "maxParallelRuns");
 	obs_data_release(data);
 }
 
@@ -61,7 +63,11 @@ MacroPropertiesDialog::MacroPropertiesDialog(QWidget *parent,
 	  _conditionsFalseStatusText(new VariableLineEdit(this)),
 	  _dockOptions(new QGroupBox(
 		  obs_module_text("AdvSceneSwitcher.macroTab.dockSettings"))),
-	  _dockLayout(new QGridLayout())
+	  _dockLayout(new QGridLayout()),
+	  _maxParallelRuns(new QSpinBox()),
+	  _currentMacroRunPolicy(new QComboBox()),
+	  _currentMacroMaxQueuedRuns(new QSpinBox()),
+	  _runLayout(new QGridLayout())
 {
 	setModal(true);
 	setWindowModality(Qt::WindowModality::WindowModal);
@@ -131,6 +137,68 @@ MacroPropertiesDialog::MacroPropertiesDialog(QWidget *parent,
 
 	_dockOptions->setLayout(_dockLayout);
 
+	_maxParallelRuns->setMinimum(0);
+	_maxParallelRuns->setMaximum(999);
+	_maxParallelRuns->setSpecialValueText(obs_module_text(
+		"AdvSceneSwitcher.macroTab.maxParallelRuns.unlimited"));
+	_currentMacroRunPolicy->addItem(obs_module_text(
+		"AdvSceneSwitcher.macroTab.currentRunPolicy.drop"));
+	_currentMacroRunPolicy->addItem(obs_module_text(
+		"AdvSceneSwitcher.macroTab.currentRunPolicy.coalesce"));
+	_currentMacroRunPolicy->addItem(obs_module_text(
+		"AdvSceneSwitcher.macroTab.currentRunPolicy.queue"));
+	_currentMacroRunPolicy->addItem(obs_module_text(
+		"AdvSceneSwitcher.macroTab.currentRunPolicy.restart"));
+	_currentMacroMaxQueuedRuns->setMinimum(1);
+	_currentMacroMaxQueuedRuns->setMaximum(999);
+
+	const auto parallelRunStats = Macro::GetParallelRunStats();
+	const QString parallelRunStatsFormat =
+		obs_module_text("AdvSceneSwitcher.macroTab.parallelRunStats");
+	auto parallelRunStatsLabel =
+		new QLabel(parallelRunStatsFormat.arg(parallelRunStats.active)
+				   .arg(parallelRunStats.waiting)
+				   .arg(parallelRunStats.peakWaiting));
+	auto runQueueStatsLabel = new QLabel();
+	if (macro) {
+		const auto runQueueStats = macro->GetRunQueueStats();
+		const QString runQueueStatsFormat = obs_module_text(
+			"AdvSceneSwitcher.macroTab.currentRunQueueStats");
+		runQueueStatsLabel->setText(
+			runQueueStatsFormat.arg(runQueueStats.queued)
+				.arg(runQueueStats.peakQueued)
+				.arg(runQueueStats.dropped));
+	}
+
+	auto runOptions = new QGroupBox(
+		obs_module_text("AdvSceneSwitcher.macroTab.runSettings"));
+	row = 0;
+	_runLayout->addWidget(
+		new QLabel(obs_module_text(
+			"AdvSceneSwitcher.macroTab.maxParallelRuns")),
+		row, 1);
+	_runLayout->addWidget(_maxParallelRuns, row, 2);
+	row++;
+	_runLayout->addWidget(parallelRunStatsLabel, row, 1, 1, 2);
+	row++;
+	_runLayout->addWidget(
+		new QLabel(obs_module_text(
+			"AdvSceneSwitcher.macroTab.currentRunPolicy")),
+		row, 1);
+	_runLayout->addWidget(_currentMacroRunPolicy, row, 2);
+	_runPolicyRow = row;
+	row++;
+	_runLayout->addWidget(
+		new QLabel(obs_module_text(
+			"AdvSceneSwitcher.macroTab.currentMaxQueuedRuns")),
+		row, 1);
+	_runLayout->addWidget(_currentMacroMaxQueuedRuns, row, 2);
+	_maxQueuedRunsRow = row;
+	row++;
+	_runLayout->addWidget(runQueueStatsLabel, row, 1, 1, 2);
+	_runQueueStatsRow = row;
+	runOptions->setLayout(_runLayout);
+
 	QDialogButtonBox *buttonbox = new QDialogButtonBox(
 		QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
 	buttonbox->setCenterButtons(true);
@@ -145,11 +213,14 @@ MacroPropertiesDialog::MacroPropertiesDialog(QWidget *parent,
 		&MacroPropertiesDialog::PauseButtonEnableChanged);
 	connect(_currentMacroDockAddStatusLabel, &QCheckBox::stateChanged, this,
 		&MacroPropertiesDialog::StatusLabelEnableChanged);
+	connect(_currentMacroRunPolicy, SIGNAL(currentIndexChanged(int)), this,
+		SLOT(RunPolicyChanged(int)));
 
 	auto layout = new QVBoxLayout;
 	layout->addWidget(highlightOptions);
 	layout->addWidget(hotkeyOptions);
 	layout->addWidget(_dockOptions);
+	layout->addWidget(runOptions);
 	layout->addWidget(buttonbox);
 	setLayout(layout);
 
@@ -157,9 +228,13 @@ MacroPropertiesDialog::MacroPropertiesDialog(QWidget *parent,
 	_conditions->setChecked(prop._highlightConditions);
 	_actions->setChecked(prop._highlightActions);
 	_newMacroRegisterHotkeys->setChecked(prop._newMacroRegisterHotkeys);
+	_maxParallelRuns->setValue(prop._maxParallelRuns);
 	if (!macro || macro->IsGroup()) {
 		hotkeyOptions->hide();
 		_dockOptions->hide();
+		SetGridLayoutRowVisible(_runLayout, _runPolicyRow, false);
+		SetGridLayoutRowVisible(_runLayout, _maxQueuedRunsRow, false);
+		SetGridLayoutRowVisible(_runLayout, _runQueueStatsRow, false);
 		return;
 	}
 	_currentMacroRegisterHotkeys->setChecked(macro->PauseHotkeysEnabled());
@@ -177,6 +252,12 @@ MacroPropertiesDialog::MacroPropertiesDialog(QWidget *parent,
 	_unpauseButtonText->setText(macro->UnpauseButtonText());
 	_conditionsTrueStatusText->setText(macro->ConditionsTrueStatusText());
 	_conditionsFalseStatusText->setText(macro->ConditionsFalseStatusText());
+	_currentMacroRunPolicy->setCurrentIndex(
+		static_cast<int>(macro->GetRunPolicy()));
+	_currentMacroMaxQueuedRuns->setValue(macro->MaxQueuedRuns());
+	SetGridLayoutRowVisible(_runLayout, _maxQueuedRunsRow,
+				macro->GetRunPolicy() ==
+					Macro::RunPolicy::QUEUE);
 
 	_currentMacroDockAddRunButton->setVisible(dockEnabled);
 	_currentMacroDockAddPauseButton->setVisible(dockEnabled);
@@ -193,6 +274,7 @@ MacroPropertiesDialog::MacroPropertiesDialog(QWidget *parent,
 	SetGridLayoutRowVisible(_dockLayout, _conditionsFalseTextRow,
 				dockEnabled && macro->DockHasStatusLabel());
 	MinimizeSizeOfColumn(_dockLayout, 0);
+	MinimizeSizeOfColumn(_runLayout, 0);
 	Resize();
 }
 
@@ -240,6 +322,14 @@ void MacroPropertiesDialog::StatusLabelEnableChanged(int enabled)
 	Resize();
 }
 
+void MacroPropertiesDialog::RunPolicyChanged(int idx)
+{
+	SetGridLayoutRowVisible(
+		_runLayout, _maxQueuedRunsRow,
+		static_cast<Macro::RunPolicy>(idx) == Macro::RunPolicy::QUEUE);
+	Resize();
+}
+
 void MacroPropertiesDialog::Resize()
 {
 	_dockOptions->adjustSize();
@@ -262,6 +352,7 @@ bool MacroPropertiesDialog::AskForSettings(QWidget *parent,
 	userInput._highlightActions = dialog._actions->isChecked();
 	userInput._newMacroRegisterHotkeys =
 		dialog._newMacroRegisterHotkeys->isChecked();
+	userInput._maxParallelRuns = dialog._maxParallelRuns->value();
 	if (!macro) {
 		return true;
 	}
@@ -286,6 +377,12 @@ bool MacroPropertiesDialog::AskForSettings(QWidget *parent,
 		dialog._conditionsTrueStatusText->text().toStdString());
 	macro->SetConditionsFalseStatusText(
 		dialog._conditionsFalseStatusText->text().toStdString());
+	if (macro->IsGroup()) {
+		return true;
+	}
+	macro->SetRunPolicy(static_cast<Macro::RunPolicy>(
+		dialog._currentMacroRunPolicy->currentIndex()));
+	macro->SetMaxQueuedRuns(dialog._currentMacroMaxQueuedRuns->value());
 	return true;
 }
 
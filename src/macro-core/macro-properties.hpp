@@ -5,8 +5,10 @@
 #include <QWidget>
 #include <QDialog>
 #include <QCheckBox>
+#include <QComboBox>
 #include <QGroupBox>
 #include <QLineEdit>
+#include <QSpinBox>
 #include <QGridLayout>
 #include <obs-data.h>
 
@@ -21,6 +23,7 @@ public:
 	bool _highlightConditions = false;
 	bool _highlightActions = false;
 	bool _newMacroRegisterHotkeys = true;
+	int _maxParallelRuns = 0;
 };
 
 // Dialog for configuring global and individual macro specific settings
@@ -37,6 +40,7 @@ private slots:
 	void RunButtonEnableChanged(int);
 	void PauseButtonEnableChanged(int);
 	void StatusLabelEnableChanged(int);
+	void RunPolicyChanged(int);
 
 private:
 	void Resize();
@@ -59,12 +63,19 @@ private:
 	VariableLineEdit *_conditionsFalseStatusText;
 	QGroupBox *_dockOptions;
 	QGridLayout *_dockLayout;
+	QSpinBox *_maxParallelRuns;
+	QComboBox *_currentMacroRunPolicy;
+	QSpinBox *_currentMacroMaxQueuedRuns;
+	QGridLayout *_runLayout;
 
 	int _runButtonTextRow = -1;
 	int _pauseButtonTextRow = -1;
 	int _unpauseButtonTextRow = -1;
 	int _conditionsTrueTextRow = -1;
 	int _conditionsFalseTextRow = -1;
+	int _runPolicyRow = -1;
+	int _maxQueuedRunsRow = -1;
+	int _runQueueStatsRow = -1;
 };
 
 } // namespace advss
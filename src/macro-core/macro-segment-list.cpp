@@ -34,6 +34,15 @@ MacroSegmentList::MacroSegmentList(QWidget *parent)
 	setWidget(wrapper);
 	setWidgetResizable(true);
 	setAcceptDrops(true);
+
+	_contentCreationTimer.setSingleShot(true);
+	connect(&_contentCreationTimer, SIGNAL(timeout()), this,
+		SLOT(CreateSegmentContent()));
+	connect(verticalScrollBar(), &QScrollBar::valueChanged, this,
+		&MacroSegmentList::ScheduleContentCreation);
+	connect(&_stateUpdateTimer, SIGNAL(timeout()), this,
+		SLOT(UpdateSegmentStates()));
+	_stateUpdateTimer.start(300);
 }
 
 MacroSegmentList::~MacroSegmentList()
@@ -81,12 +90,82 @@ void MacroSegmentList::Insert(int idx, MacroSegmentEdit *widget)
 {
 	widget->installEventFilter(this);
 	_contentLayout->insertWidget(idx, widget);
+	ScheduleContentCreation();
 }
 
 void MacroSegmentList::Add(QWidget *widget)
 {
 	widget->installEventFilter(this);
 	_contentLayout->addWidget(widget);
+	ScheduleContentCreation();
+}
+
+void MacroSegmentList::ScheduleContentCreation()
+{
+	if (!_contentCreationTimer.isActive()) {
+		_contentCreationTimer.start(0);
+	}
+}
+
+void MacroSegmentList::CreateSegmentContent()
+{
+	const QRect visibleArea(QPoint(0, verticalScrollBar()->value()),
+				viewport()->size());
+	MacroSegmentEdit *firstPending = nullptr;
+	bool createdVisible = false;
+	int pendingCount = 0;
+	for (int i = 0; i < _contentLayout->count(); i++) {
+		auto segment = dynamic_cast<MacroSegmentEdit *>(
+			_contentLayout->itemAt(i)->widget());
+		if (!segment || segment->ContentCreated()) {
+			continue;
+		}
+		if (segment->geometry().intersects(visibleArea)) {
+			segment->CreateContent();
+			createdVisible = true;
+			continue;
+		}
+		if (!firstPending) {
+			firstPending = segment;
+		}
+		pendingCount++;
+	}
+
+	// Create the content of the remaining segments one at a time, so the
+	// UI stays responsive and the scroll area eventually settles to its
+	// final size
+	if (!createdVisible && firstPending) {
+		firstPending->CreateContent();
+		pendingCount--;
+	}
+	if (pendingCount > 0) {
+		_contentCreationTimer.start(0);
+	}
+}
+
+void MacroSegmentList::UpdateSegmentStates()
+{
+	// Highlighting is checked less frequently than the other states
+	constexpr int highlightInterval = 5;
+	const bool checkHighlight =
+		++_stateUpdateCount % highlightInterval == 0;
+	for (int i = 0; i < _contentLayout->count(); i++) {
+		auto segment = dynamic_cast<MacroSegmentEdit *>(
+			_contentLayout->itemAt(i)->widget());
+		if (!segment) {
+			continue;
+		}
+		segment->UpdateState();
+		if (checkHighlight) {
+			segment->Highlight();
+		}
+	}
+}
+
+void MacroSegmentList::resizeEvent(QResizeEvent *event)
+{
+	QScrollArea::resizeEvent(event);
+	ScheduleContentCreation();
 }
 
 void MacroSegmentList::Remove(int idx)
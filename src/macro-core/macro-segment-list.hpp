@@ -5,6 +5,7 @@
 #include <QScrollArea>
 #include <QVBoxLayout>
 #include <QLabel>
+#include <QTimer>
 #include <thread>
 
 namespace advss {
@@ -31,6 +32,10 @@ signals:
 	void SelectionChagned(int idx);
 	void Reorder(int source, int target);
 
+private slots:
+	void UpdateSegmentStates();
+	void CreateSegmentContent();
+
 protected:
 	bool eventFilter(QObject *object, QEvent *event);
 	void mousePressEvent(QMouseEvent *event);
@@ -40,6 +45,7 @@ protected:
 	void dragEnterEvent(QDragEnterEvent *event);
 	void dragMoveEvent(QDragMoveEvent *event);
 	void dropEvent(QDropEvent *event);
+	void resizeEvent(QResizeEvent *event);
 
 private:
 	int GetDragIndex(const QPoint &);
@@ -50,6 +56,7 @@ private:
 	bool IsInListArea(const QPoint &);
 	QRect GetContentItemRectWithPadding(int idx);
 	void HideLastDropLine();
+	void ScheduleContentCreation();
 
 	int _dragPosition = -1;
 	int _dropLineIdx = -1;
@@ -57,6 +64,14 @@ private:
 	std::thread _autoScrollThread;
 	std::atomic_bool _autoScroll{false};
 
+	// Content of segments is created lazily, prioritizing the segments
+	// which are currently visible
+	QTimer _contentCreationTimer;
+	// Shared by all segments to avoid each segment waking up the UI thread
+	// on its own
+	QTimer _stateUpdateTimer;
+	int _stateUpdateCount = 0;
+
 	QVBoxLayout *_layout;
 	QVBoxLayout *_contentLayout;
 	QLabel *_helpMsg;
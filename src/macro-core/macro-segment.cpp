@@ -172,10 +172,6 @@ MacroSegmentEdit::MacroSegmentEdit(bool highlight, QWidget *parent)
 
 	// Enable dragging while clicking on the header text
 	_headerInfo->installEventFilter(this);
-
-	_timer.setInterval(1500);
-	connect(&_timer, SIGNAL(timeout()), this, SLOT(Highlight()));
-	_timer.start();
 }
 
 bool MacroSegmentEdit::eventFilter(QObject *obj, QEvent *ev)
@@ -243,6 +239,16 @@ void MacroSegmentEdit::SetCollapsed(bool collapsed)
 	_section->SetCollapsed(collapsed);
 }
 
+bool MacroSegmentEdit::ContentCreated() const
+{
+	return _section->ContentCreated();
+}
+
+void MacroSegmentEdit::CreateContent()
+{
+	_section->CreateContent();
+}
+
 void MacroSegmentEdit::SetSelected(bool selected)
 {
 	_borderFrame->setVisible(selected);
@@ -32,6 +32,9 @@ public:
 	virtual bool PostLoad();
 	virtual std::string GetShortDesc() const;
 	virtual std::string GetId() const = 0;
+	// Segments modifying their saved settings while the macro is running
+	// have to be serialized again on every save
+	virtual bool HasRuntimeSaveData() const { return false; }
 	void SetHighlight();
 	bool Highlight();
 	bool SupportsVariableValue() const { return _supportsVariableValue; }
@@ -70,6 +73,8 @@ public:
 	void SetFocusPolicyOfWidgets();
 	void SetCollapsed(bool collapsed);
 	void SetSelected(bool);
+	bool ContentCreated() const;
+	void CreateContent();
 
 protected slots:
 	void HeaderInfoChanged(const QString &);
@@ -86,6 +91,8 @@ signals:
 
 protected:
 	bool eventFilter(QObject *obj, QEvent *ev) override;
+	// Called periodically by the MacroSegmentList containing this widget
+	virtual void UpdateState() {}
 
 	Section *_section;
 	QLabel *_headerInfo;
@@ -119,7 +126,6 @@ private:
 	QFrame *_dropLineBelow;
 
 	bool _showHighlight;
-	QTimer _timer;
 
 	friend class MacroSegmentList;
 };
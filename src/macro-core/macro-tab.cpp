@@ -476,6 +476,7 @@ void AdvSceneSwitcher::SetConditionData(Macro &m)
 
 void AdvSceneSwitcher::SetEditMacro(Macro &m)
 {
+	m.SetModified();
 	{
 		const QSignalBlocker b1(ui->macroName);
 		const QSignalBlocker b2(ui->runMacroInParallel);
@@ -578,6 +579,7 @@ void AdvSceneSwitcher::on_macroProperties_clicked()
 		return;
 	}
 	switcher->macroProperties = prop;
+	Macro::SetMaxParallelRuns(prop._maxParallelRuns);
 	emit HighlightMacrosChanged(prop._highlightExecuted);
 	emit HighlightActionsChanged(prop._highlightActions);
 	emit HighlightConditionsChanged(prop._highlightConditions);
@@ -4,198 +4,16 @@
 #include "switcher-data.hpp"
 
 #include <obs.h>
+#include <algorithm>
 #include <string>
-#include <QLabel>
-#include <QLineEdit>
-#include <QSpacerItem>
-#include <QPushButton>
-#include <QVBoxLayout>
-#include <QHBoxLayout>
 #include <QMouseEvent>
-#include <QStylePainter>
+#include <QPainter>
+#include <QStyleOption>
 
 Q_DECLARE_METATYPE(std::shared_ptr<advss::Macro>);
 
 namespace advss {
 
-MacroTreeItem::MacroTreeItem(MacroTree *tree, std::shared_ptr<Macro> macroItem,
-			     bool highlight)
-	: _tree(tree), _highlight(highlight), _macro(macroItem)
-{
-	setAttribute(Qt::WA_TranslucentBackground);
-	// This is necessary for some theses to display active selections properly
-	setStyleSheet("background: none");
-
-	auto name = _macro->Name();
-	bool macroPaused = _macro->Paused();
-	bool isGroup = _macro->IsGroup();
-
-	if (isGroup) {
-		const auto path = QString::fromStdString(GetDataFilePath(
-			"res/images/" + GetThemeTypeName() + "Group.svg"));
-		QIcon icon(path);
-		QPixmap pixmap = icon.pixmap(QSize(16, 16));
-		_iconLabel = new QLabel();
-		_iconLabel->setPixmap(pixmap);
-		_iconLabel->setStyleSheet("background: none");
-	}
-
-	_running = new QCheckBox();
-	_running->setSizePolicy(QSizePolicy::Maximum, QSizePolicy::Maximum);
-	_running->setChecked(!macroPaused);
-	_running->setStyleSheet("background: none");
-
-	_label = new QLabel(QString::fromStdString(name));
-	_label->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Preferred);
-	_label->setAlignment(Qt::AlignLeft | Qt::AlignVCenter);
-	_label->setAttribute(Qt::WA_TranslucentBackground);
-
-#ifdef __APPLE__
-	_running->setAttribute(Qt::WA_LayoutUsesWidgetRect);
-#endif
-
-	_boxLayout = new QHBoxLayout();
-	_boxLayout->setContentsMargins(0, 0, 0, 0);
-	_boxLayout->addWidget(_running);
-	if (isGroup) {
-		_boxLayout->addWidget(_iconLabel);
-		_boxLayout->addSpacing(2);
-		_running->hide();
-	}
-	_boxLayout->addWidget(_label);
-#ifdef __APPLE__
-	/* Hack: Fixes a bug where scrollbars would be above the lock icon */
-	_boxLayout->addSpacing(16);
-#endif
-
-	Update(true);
-	setLayout(_boxLayout);
-
-	auto setRunning = [this](bool val) { _macro->SetPaused(!val); };
-	connect(_running, &QAbstractButton::clicked, setRunning);
-	connect(_tree->window(), SIGNAL(HighlightMacrosChanged(bool)), this,
-		SLOT(EnableHighlight(bool)));
-	connect(_tree->window(),
-		SIGNAL(MacroRenamed(const QString &, const QString &)), this,
-		SLOT(MacroRenamed(const QString &, const QString &)));
-	connect(&_timer, SIGNAL(timeout()), this, SLOT(HighlightIfExecuted()));
-	connect(&_timer, SIGNAL(timeout()), this, SLOT(UpdatePaused()));
-	_timer.start(1500);
-}
-
-void MacroTreeItem::EnableHighlight(bool enable)
-{
-	_highlight = enable;
-}
-
-void MacroTreeItem::UpdatePaused()
-{
-	const QSignalBlocker blocker(_running);
-	_running->setChecked(!_macro->Paused());
-}
-
-void MacroTreeItem::HighlightIfExecuted()
-{
-	if (!_highlight || !_macro) {
-		return;
-	}
-
-	if (_lastHighlightCheckTime.time_since_epoch().count() != 0 &&
-	    _macro->ExecutedSince(_lastHighlightCheckTime)) {
-		PulseWidget(this, Qt::green, QColor(0, 0, 0, 0), true);
-	}
-	_lastHighlightCheckTime = std::chrono::high_resolution_clock::now();
-}
-
-void MacroTreeItem::MacroRenamed(const QString &oldName, const QString &newName)
-{
-	if (_label->text() == oldName) {
-		_label->setText(newName);
-	}
-}
-
-void MacroTreeItem::paintEvent(QPaintEvent *event)
-{
-	QStyleOption opt;
-	opt.initFrom(this);
-	QPainter p(this);
-	style()->drawPrimitive(QStyle::PE_Widget, &opt, &p, this);
-
-	QWidget::paintEvent(event);
-}
-
-void MacroTreeItem::mouseDoubleClickEvent(QMouseEvent *event)
-{
-	QWidget::mouseDoubleClickEvent(event);
-	if (_expand) {
-		_expand->setChecked(!_expand->isChecked());
-	}
-}
-
-void MacroTreeItem::Update(bool force)
-{
-	Type newType;
-
-	if (_macro->IsGroup()) {
-		newType = Type::Group;
-	} else if (_macro->IsSubitem()) {
-		newType = Type::SubItem;
-	} else {
-		newType = Type::Item;
-	}
-
-	if (!force && newType == _type) {
-		return;
-	}
-
-	if (_spacer) {
-		_boxLayout->removeItem(_spacer);
-		delete _spacer;
-		_spacer = nullptr;
-	}
-
-	if (_type == Type::Group) {
-		_boxLayout->removeWidget(_expand);
-		_expand->deleteLater();
-		_expand = nullptr;
-	}
-
-	_type = newType;
-	if (_type == Type::SubItem) {
-		_spacer = new QSpacerItem(16, 1);
-		_boxLayout->insertItem(0, _spacer);
-
-	} else if (_type == Type::Group) {
-		_expand = new SourceTreeSubItemCheckBox();
-		_expand->setSizePolicy(QSizePolicy::Maximum,
-				       QSizePolicy::Maximum);
-		_expand->setMaximumSize(10, 16);
-		_expand->setMinimumSize(10, 0);
-#ifdef __APPLE__
-		_expand->setAttribute(Qt::WA_LayoutUsesWidgetRect);
-#endif
-		_boxLayout->insertWidget(0, _expand);
-		_expand->blockSignals(true);
-		_expand->setChecked(_macro->IsCollapsed());
-		_expand->blockSignals(false);
-		connect(_expand, &QPushButton::toggled, this,
-			&MacroTreeItem::ExpandClicked);
-	} else {
-		_spacer = new QSpacerItem(3, 1);
-		_boxLayout->insertItem(0, _spacer);
-	}
-	_label->setText(QString::fromStdString(_macro->Name()));
-}
-
-void MacroTreeItem::ExpandClicked(bool checked)
-{
-	if (!checked) {
-		_tree->GetModel()->ExpandGroup(_macro);
-	} else {
-		_tree->GetModel()->CollapseGroup(_macro);
-	}
-}
-
 /* ========================================================================= */
 
 void MacroTreeModel::Reset(std::deque<std::shared_ptr<Macro>> &newItems)
@@ -203,9 +21,10 @@ void MacroTreeModel::Reset(std::deque<std::shared_ptr<Macro>> &newItems)
 	beginResetModel();
 	_macros = newItems;
 	endResetModel();
+	switcher->PublishMacros();
 
 	UpdateGroupState(false);
-	_mt->ResetWidgets();
+	assert(IsInValidState());
 }
 
 static inline int
@@ -400,7 +219,7 @@ void MacroTreeModel::Add(std::shared_ptr<Macro> item)
 	beginInsertRows(QModelIndex(), idx, idx);
 	_macros.emplace_back(item);
 	endInsertRows();
-	_mt->UpdateWidget(createIndex(idx, 0, nullptr), item);
+	switcher->PublishMacros();
 	_mt->selectionModel()->clear();
 	_mt->selectionModel()->select(createIndex(idx, 0, nullptr),
 				      QItemSelectionModel::Select);
@@ -432,6 +251,7 @@ void MacroTreeModel::Remove(std::shared_ptr<Macro> item)
 	_macros.erase(std::next(_macros.begin(), macroStartIdx),
 		      std::next(_macros.begin(), macroEndIdx + 1));
 	endRemoveRows();
+	switcher->PublishMacros();
 
 	_mt->selectionModel()->clear();
 
@@ -502,7 +322,40 @@ std::shared_ptr<Macro> MacroTreeModel::GetCurrentMacro() const
 	if (idx >= (int)_macros.size()) {
 		return std::shared_ptr<Macro>();
 	}
-	return _macros[ModelIndexToMacroIndex(idx, _macros)];
+	return GetMacro(idx);
+}
+
+int MacroTreeModel::RowToMacroIndex(int row) const
+{
+	if (!_rowMappingValid) {
+		_rowToMacroIndex.clear();
+		for (int i = 0; i < (int)_macros.size(); i++) {
+			_rowToMacroIndex.push_back(i);
+			const auto &m = _macros[i];
+			if (m->IsGroup() && m->IsCollapsed()) {
+				i += m->GroupSize();
+			}
+		}
+		_rowMappingValid = true;
+	}
+	if (row < 0 || row >= (int)_rowToMacroIndex.size()) {
+		return -1;
+	}
+	return _rowToMacroIndex[row];
+}
+
+void MacroTreeModel::InvalidateRowMapping()
+{
+	_rowMappingValid = false;
+}
+
+std::shared_ptr<Macro> MacroTreeModel::GetMacro(int row) const
+{
+	const int idx = RowToMacroIndex(row);
+	if (idx < 0 || idx >= (int)_macros.size()) {
+		return std::shared_ptr<Macro>();
+	}
+	return _macros[idx];
 }
 
 std::vector<std::shared_ptr<Macro>>
@@ -511,10 +364,9 @@ MacroTreeModel::GetCurrentMacros(const QModelIndexList &selection) const
 	std::vector<std::shared_ptr<Macro>> result;
 	result.reserve(selection.size());
 	for (const auto &sel : selection) {
-		try {
-			result.emplace_back(_macros.at(
-				ModelIndexToMacroIndex(sel.row(), _macros)));
-		} catch (const std::out_of_range &) {
+		auto macro = GetMacro(sel.row());
+		if (macro) {
+			result.emplace_back(macro);
 		}
 	}
 	return result;
@@ -524,6 +376,24 @@ MacroTreeModel::MacroTreeModel(MacroTree *st_,
 			       std::deque<std::shared_ptr<Macro>> &macros)
 	: QAbstractListModel(st_), _mt(st_), _macros(macros)
 {
+	// The row mapping is rebuilt lazily once the layout of the model
+	// changed, which includes collapsing and expanding groups
+	const auto layoutSignals = {
+		SIGNAL(modelAboutToBeReset()),
+		SIGNAL(modelReset()),
+		SIGNAL(rowsAboutToBeInserted(const QModelIndex &, int, int)),
+		SIGNAL(rowsInserted(const QModelIndex &, int, int)),
+		SIGNAL(rowsAboutToBeRemoved(const QModelIndex &, int, int)),
+		SIGNAL(rowsRemoved(const QModelIndex &, int, int)),
+		SIGNAL(rowsAboutToBeMoved(const QModelIndex &, int, int,
+					  const QModelIndex &, int)),
+		SIGNAL(rowsMoved(const QModelIndex &, int, int,
+				 const QModelIndex &, int)),
+		SIGNAL(layoutChanged()),
+	};
+	for (const auto signal : layoutSignals) {
+		connect(this, signal, this, SLOT(InvalidateRowMapping()));
+	}
 	UpdateGroupState(false);
 }
 
@@ -534,9 +404,8 @@ int MacroTreeModel::rowCount(const QModelIndex &parent) const
 
 QVariant MacroTreeModel::data(const QModelIndex &index, int role) const
 {
-	if (role == Qt::AccessibleTextRole) {
-		std::shared_ptr<Macro> item =
-			_macros[ModelIndexToMacroIndex(index.row(), _macros)];
+	if (role == Qt::AccessibleTextRole || role == Qt::DisplayRole) {
+		std::shared_ptr<Macro> item = GetMacro(index.row());
 		if (!item) {
 			return QVariant();
 		}
@@ -552,10 +421,8 @@ Qt::ItemFlags MacroTreeModel::flags(const QModelIndex &index) const
 		return QAbstractListModel::flags(index) | Qt::ItemIsDropEnabled;
 	}
 
-	std::shared_ptr<Macro> item;
-	try {
-		item = _macros.at(ModelIndexToMacroIndex(index.row(), _macros));
-	} catch (const std::out_of_range &) {
+	std::shared_ptr<Macro> item = GetMacro(index.row());
+	if (!item) {
 		return QAbstractListModel::flags(index) | Qt::ItemIsDropEnabled;
 	}
 	bool isGroup = item->IsGroup();
@@ -749,7 +616,7 @@ void MacroTreeModel::UpdateGroupState(bool update)
 	if (nowHasGroups != _hasGroups) {
 		_hasGroups = nowHasGroups;
 		if (update) {
-			_mt->UpdateWidgets(true);
+			_mt->viewport()->update();
 		}
 	}
 }
@@ -758,6 +625,14 @@ void MacroTree::Reset(std::deque<std::shared_ptr<Macro>> &macros,
 		      bool highlight)
 {
 	_highlight = highlight;
+	_highlightStartTimes.clear();
+	_lastHighlightCheckTimes.clear();
+	connect(window(), SIGNAL(HighlightMacrosChanged(bool)), this,
+		SLOT(EnableHighlight(bool)), Qt::UniqueConnection);
+	connect(window(),
+		SIGNAL(MacroRenamed(const QString &, const QString &)), this,
+		SLOT(MacroRenamed(const QString &, const QString &)),
+		Qt::UniqueConnection);
 	MacroTreeModel *mtm = new MacroTreeModel(this, macros);
 	setModel(mtm);
 	GetModel()->Reset(macros);
@@ -803,52 +678,131 @@ MacroTree::MacroTree(QWidget *parent_) : QListView(parent_)
 		"*[bgColor=\"8\"]{background-color:rgba(255,255,255,33%);}"));
 
 	setItemDelegate(new MacroTreeDelegate(this));
+	// Items are renamed via the macro settings
+	setEditTriggers(QAbstractItemView::NoEditTriggers);
+	setUniformItemSizes(true);
+
+	connect(&_refreshTimer, SIGNAL(timeout()), this,
+		SLOT(RefreshVisibleItems()));
+	connect(&_highlightAnimationTimer, SIGNAL(timeout()), this,
+		SLOT(AnimateHighlights()));
+	_refreshTimer.start(1500);
 }
 
-void MacroTree::ResetWidgets()
+void MacroTree::EnableHighlight(bool enable)
 {
-	MacroTreeModel *mtm = GetModel();
-	mtm->UpdateGroupState(false);
-	int modelIdx = 0;
-	for (int i = 0; i < (int)mtm->_macros.size(); i++) {
-		QModelIndex index = mtm->createIndex(modelIdx, 0, nullptr);
-		const auto &macro = mtm->_macros[i];
-		setIndexWidget(index,
-			       new MacroTreeItem(this, macro, _highlight));
-
-		// Skip items of collapsed groups
-		if (macro->IsGroup() && macro->IsCollapsed()) {
-			i += macro->GroupSize();
-		}
-		modelIdx++;
+	_highlight = enable;
+	if (!enable) {
+		_highlightStartTimes.clear();
+		_highlightAnimationTimer.stop();
+		viewport()->update();
 	}
-	assert(GetModel()->IsInValidState());
 }
 
-void MacroTree::UpdateWidget(const QModelIndex &idx,
-			     std::shared_ptr<Macro> item)
+void MacroTree::MacroRenamed(const QString &, const QString &)
 {
-	setIndexWidget(idx, new MacroTreeItem(this, item, _highlight));
+	viewport()->update();
 }
 
-void MacroTree::UpdateWidgets(bool force)
+void MacroTree::GetVisibleRows(int &first, int &last) const
 {
-	MacroTreeModel *mtm = GetModel();
+	const int rows = model() ? model()->rowCount() : 0;
+	first = -1;
+	last = -1;
+	if (rows == 0) {
+		return;
+	}
 
-	for (int i = 0; i < (int)mtm->_macros.size(); i++) {
-		std::shared_ptr<Macro> item = mtm->_macros[i];
-		MacroTreeItem *widget = GetItemWidget(i);
+	first = indexAt(QPoint(0, 0)).row();
+	if (first == -1) {
+		first = 0;
+	}
+	last = indexAt(QPoint(0, viewport()->height() - 1)).row();
+	if (last == -1) {
+		last = rows - 1;
+	}
+}
 
-		if (!widget) {
-			UpdateWidget(mtm->createIndex(i, 0, nullptr), item);
-		} else {
-			widget->Update(force);
+void MacroTree::RefreshVisibleItems()
+{
+	const auto mtm = GetModel();
+	if (!mtm || !isVisible()) {
+		return;
+	}
+
+	int first, last;
+	GetVisibleRows(first, last);
+
+	const auto now = std::chrono::high_resolution_clock::now();
+	bool repaint = first != _firstVisibleRow;
+	if (first == -1) {
+		_visiblePausedState.clear();
+	} else {
+		_visiblePausedState.resize(last - first + 1);
+	}
+	_firstVisibleRow = first;
+
+	for (int row = first; row != -1 && row <= last; row++) {
+		const auto macro = mtm->GetMacro(row);
+		if (!macro) {
+			continue;
+		}
+		const bool paused = macro->Paused();
+		if (_visiblePausedState[row - first] != paused) {
+			_visiblePausedState[row - first] = paused;
+			repaint = true;
 		}
-		// Skip items of collapsed groups
-		if (item->IsGroup() && item->IsCollapsed()) {
-			i += item->GroupSize();
+		// Tracked per macro, so executions of macros which were
+		// scrolled out of view are highlighted once they are visible
+		auto &lastCheck = _lastHighlightCheckTimes[macro.get()];
+		if (_highlight && lastCheck.time_since_epoch().count() != 0 &&
+		    macro->ExecutedSince(lastCheck)) {
+			_highlightStartTimes[macro.get()] =
+				std::chrono::steady_clock::now();
+			repaint = true;
 		}
+		lastCheck = now;
+	}
+
+	if (!_highlightStartTimes.empty() &&
+	    !_highlightAnimationTimer.isActive()) {
+		_highlightAnimationTimer.start(30);
 	}
+	if (repaint) {
+		viewport()->update();
+	}
+}
+
+constexpr auto highlightDuration = std::chrono::milliseconds(1000);
+
+double MacroTree::GetHighlightStrength(const Macro *macro) const
+{
+	auto it = _highlightStartTimes.find(macro);
+	if (it == _highlightStartTimes.end()) {
+		return 0.;
+	}
+	const std::chrono::duration<double, std::milli> elapsed =
+		std::chrono::steady_clock::now() - it->second;
+	const double strength =
+		1. - elapsed.count() / highlightDuration.count();
+	return strength > 0. ? strength : 0.;
+}
+
+void MacroTree::AnimateHighlights()
+{
+	const auto now = std::chrono::steady_clock::now();
+	for (auto it = _highlightStartTimes.begin();
+	     it != _highlightStartTimes.end();) {
+		if (now - it->second > highlightDuration) {
+			it = _highlightStartTimes.erase(it);
+		} else {
+			++it;
+		}
+	}
+	if (_highlightStartTimes.empty()) {
+		_highlightAnimationTimer.stop();
+	}
+	viewport()->update();
 }
 
 static inline void MoveItem(std::deque<std::shared_ptr<Macro>> &items,
@@ -1100,9 +1054,12 @@ void MacroTree::dropEvent(QDropEvent *event)
 				       GroupNameMatches);
 		items.insert(std::next(it, 1), i);
 	}
+	// The model signals above were emitted before the backend was updated
+	mtm->InvalidateRowMapping();
+	switcher->PublishMacros();
 
-	// Update widgets and accept event
-	UpdateWidgets(true);
+	// Repaint items and accept event
+	viewport()->update();
 	event->accept();
 	event->setDropAction(Qt::CopyAction);
 
@@ -1161,12 +1118,14 @@ void MacroTree::MoveItemBefore(const std::shared_ptr<Macro> &item,
 			       const std::shared_ptr<Macro> &after) const
 {
 	GetModel()->MoveItemBefore(item, after);
+	switcher->PublishMacros();
 }
 
 void MacroTree::MoveItemAfter(const std::shared_ptr<Macro> &item,
 			      const std::shared_ptr<Macro> &after) const
 {
 	GetModel()->MoveItemAfter(item, after);
+	switcher->PublishMacros();
 }
 
 MacroTreeModel *MacroTree::GetModel() const
@@ -1263,12 +1222,6 @@ void MacroTree::SelectionChangedHelper(const QItemSelection &,
 	emit MacroSelectionChanged();
 }
 
-inline MacroTreeItem *MacroTree::GetItemWidget(int idx) const
-{
-	QWidget *widget = indexWidget(GetModel()->createIndex(idx, 0, nullptr));
-	return reinterpret_cast<MacroTreeItem *>(widget);
-}
-
 void MacroTree::paintEvent(QPaintEvent *event)
 {
 	MacroTreeModel *mtm = GetModel();
@@ -1285,22 +1238,173 @@ void MacroTree::paintEvent(QPaintEvent *event)
 	}
 }
 
-MacroTreeDelegate::MacroTreeDelegate(QObject *parent)
-	: QStyledItemDelegate(parent)
+MacroTreeDelegate::MacroTreeDelegate(MacroTree *parent)
+	: QStyledItemDelegate(parent),
+	  _tree(parent),
+	  _groupIcon(QString::fromStdString(GetDataFilePath(
+		  "res/images/" + GetThemeTypeName() + "Group.svg")))
+{
+}
+
+constexpr int itemMargin = 2;
+constexpr int iconSize = 16;
+constexpr int subItemIndent = 16;
+
+MacroTreeDelegate::Layout
+MacroTreeDelegate::GetLayout(const QStyleOptionViewItem &option,
+			     const Macro &macro) const
+{
+	const auto style = _tree->style();
+	const QRect &rect = option.rect;
+	const int indicatorWidth =
+		style->pixelMetric(QStyle::PM_IndicatorWidth, &option);
+	const int indicatorHeight =
+		style->pixelMetric(QStyle::PM_IndicatorHeight, &option);
+	const auto centered = [&rect](int x, int width, int height) {
+		return QRect(x, rect.top() + (rect.height() - height) / 2,
+			     width, height);
+	};
+
+	Layout layout;
+	int x = rect.left() + itemMargin;
+	if (macro.IsGroup()) {
+		layout.expand = centered(x, 10, iconSize);
+		x = layout.expand.right() + 1 + itemMargin;
+		layout.icon = centered(x, iconSize, iconSize);
+		x = layout.icon.right() + 1 + itemMargin;
+	} else {
+		if (macro.IsSubitem()) {
+			x += subItemIndent;
+		}
+		layout.running =
+			centered(x, indicatorWidth, indicatorHeight);
+		x = layout.running.right() + 1 + itemMargin;
+	}
+	layout.text = QRect(x, rect.top(), rect.right() - x, rect.height());
+	return layout;
+}
+
+void MacroTreeDelegate::paint(QPainter *painter,
+			      const QStyleOptionViewItem &option,
+			      const QModelIndex &index) const
 {
+	const auto macro = _tree->GetModel()->GetMacro(index.row());
+	if (!macro) {
+		return;
+	}
+
+	QStyleOptionViewItem opt = option;
+	initStyleOption(&opt, index);
+	opt.text.clear();
+	const auto widget = opt.widget;
+	const auto style = widget ? widget->style() : _tree->style();
+	style->drawControl(QStyle::CE_ItemViewItem, &opt, painter, widget);
+
+	const double highlight = _tree->GetHighlightStrength(macro.get());
+	if (highlight > 0.) {
+		painter->fillRect(option.rect,
+				  QColor(0, 255, 0, int(100 * highlight)));
+	}
+
+	const auto layout = GetLayout(option, *macro);
+	if (macro->IsGroup()) {
+		QStyleOption arrow;
+		arrow.rect = layout.expand;
+		arrow.palette = option.palette;
+		arrow.state = QStyle::State_Enabled;
+		style->drawPrimitive(macro->IsCollapsed()
+					     ? QStyle::PE_IndicatorArrowRight
+					     : QStyle::PE_IndicatorArrowDown,
+				     &arrow, painter, widget);
+		_groupIcon.paint(painter, layout.icon);
+	} else {
+		QStyleOptionButton checkBox;
+		checkBox.rect = layout.running;
+		checkBox.palette = option.palette;
+		checkBox.state = QStyle::State_Enabled |
+				 (macro->Paused() ? QStyle::State_Off
+						  : QStyle::State_On);
+		style->drawPrimitive(QStyle::PE_IndicatorCheckBox, &checkBox,
+				     painter, widget);
+	}
+
+	const bool selected = option.state & QStyle::State_Selected;
+	painter->save();
+	painter->setPen(option.palette.color(
+		selected ? QPalette::HighlightedText : QPalette::Text));
+	const auto name = QString::fromStdString(macro->Name());
+	painter->drawText(layout.text, Qt::AlignLeft | Qt::AlignVCenter,
+			  option.fontMetrics.elidedText(name, Qt::ElideRight,
+							layout.text.width()));
+	painter->restore();
 }
 
 QSize MacroTreeDelegate::sizeHint(const QStyleOptionViewItem &option,
-				  const QModelIndex &index) const
+				  const QModelIndex &) const
 {
-	MacroTree *tree = qobject_cast<MacroTree *>(parent());
-	QWidget *item = tree->indexWidget(index);
+	const int indicatorHeight = _tree->style()->pixelMetric(
+		QStyle::PM_IndicatorHeight, &option);
+	const int height = std::max({option.fontMetrics.height(),
+				     indicatorHeight, iconSize}) +
+			   2 * itemMargin;
+	return QSize(option.widget ? option.widget->minimumWidth() : 0, height);
+}
 
-	if (!item) {
-		return (QSize(0, 0));
+bool MacroTreeDelegate::editorEvent(QEvent *event, QAbstractItemModel *model,
+				    const QStyleOptionViewItem &option,
+				    const QModelIndex &index)
+{
+	const auto type = event->type();
+	if (type != QEvent::MouseButtonPress &&
+	    type != QEvent::MouseButtonRelease &&
+	    type != QEvent::MouseButtonDblClick) {
+		return QStyledItemDelegate::editorEvent(event, model, option,
+							index);
+	}
+
+	const auto macro = _tree->GetModel()->GetMacro(index.row());
+	const auto mouseEvent = static_cast<QMouseEvent *>(event);
+	if (!macro || mouseEvent->button() != Qt::LeftButton) {
+		return QStyledItemDelegate::editorEvent(event, model, option,
+							index);
+	}
+
+	const auto layout = GetLayout(option, *macro);
+	const auto pos = mouseEvent->pos();
+	const bool onExpand = layout.expand.contains(pos);
+	const bool toggleGroup =
+		macro->IsGroup() &&
+		((type == QEvent::MouseButtonDblClick && !onExpand) ||
+		 (type == QEvent::MouseButtonRelease && onExpand));
+	if (toggleGroup) {
+		// Expanding or collapsing resets the model, which must not
+		// happen while the view is still processing this event
+		auto tree = _tree;
+		QMetaObject::invokeMethod(
+			tree,
+			[tree, macro]() {
+				auto mtm = tree->GetModel();
+				if (macro->IsCollapsed()) {
+					mtm->ExpandGroup(macro);
+				} else {
+					mtm->CollapseGroup(macro);
+				}
+			},
+			Qt::QueuedConnection);
+		return true;
 	}
 
-	return (QSize(option.widget->minimumWidth(), item->height()));
+	const auto &clickArea = macro->IsGroup() ? layout.expand
+						 : layout.running;
+	if (!clickArea.contains(pos)) {
+		return QStyledItemDelegate::editorEvent(event, model, option,
+							index);
+	}
+	if (type == QEvent::MouseButtonRelease && !macro->IsGroup()) {
+		macro->SetPaused(!macro->Paused());
+		_tree->viewport()->update(option.rect);
+	}
+	return true;
 }
 
 } // namespace advss
@@ -1,75 +1,21 @@
 #pragma once
 
 #include <QTimer>
-#include <QLabel>
-#include <QCheckBox>
 #include <QListView>
-#include <QStaticText>
 #include <QAbstractListModel>
 #include <QStyledItemDelegate>
 
 #include <memory>
 #include <deque>
 #include <chrono>
-
-class QLabel;
-class QSpacerItem;
-class QHBoxLayout;
-
-// Only used to enable applying "SourceTreeSubItemCheckBox" stylesheet
-class SourceTreeSubItemCheckBox : public QCheckBox {
-	Q_OBJECT
-};
+#include <unordered_map>
+#include <vector>
 
 namespace advss {
 
 class Macro;
 class MacroTree;
 
-class MacroTreeItem : public QFrame {
-	Q_OBJECT
-
-public:
-	explicit MacroTreeItem(MacroTree *tree, std::shared_ptr<Macro> macro,
-			       bool highlight);
-
-private slots:
-	void ExpandClicked(bool checked);
-	void EnableHighlight(bool enable);
-	void UpdatePaused();
-	void HighlightIfExecuted();
-	void MacroRenamed(const QString &, const QString &);
-
-private:
-	virtual void paintEvent(QPaintEvent *event) override;
-	void mouseDoubleClickEvent(QMouseEvent *event) override;
-	void Update(bool force);
-
-	enum class Type {
-		Unknown,
-		Item,
-		Group,
-		SubItem,
-	};
-
-	Type _type = Type::Unknown;
-
-	QSpacerItem *_spacer = nullptr;
-	QCheckBox *_expand = nullptr;
-	QLabel *_iconLabel = nullptr;
-	QCheckBox *_running = nullptr;
-	QHBoxLayout *_boxLayout = nullptr;
-	QLabel *_label = nullptr;
-	MacroTree *_tree;
-	bool _highlight;
-	std::chrono::high_resolution_clock::time_point _lastHighlightCheckTime{};
-	QTimer _timer;
-	std::shared_ptr<Macro> _macro;
-
-	friend class MacroTree;
-	friend class MacroTreeModel;
-};
-
 class MacroTreeModel : public QAbstractListModel {
 	Q_OBJECT
 
@@ -83,6 +29,9 @@ public:
 	virtual Qt::ItemFlags flags(const QModelIndex &index) const override;
 	virtual Qt::DropActions supportedDropActions() const override;
 
+private slots:
+	void InvalidateRowMapping();
+
 private:
 	void Reset(std::deque<std::shared_ptr<Macro>> &);
 	void MoveItemBefore(const std::shared_ptr<Macro> &item,
@@ -98,6 +47,8 @@ private:
 	std::shared_ptr<Macro> GetCurrentMacro() const;
 	std::vector<std::shared_ptr<Macro>>
 	GetCurrentMacros(const QModelIndexList &) const;
+	std::shared_ptr<Macro> GetMacro(int row) const;
+	int RowToMacroIndex(int row) const;
 	QString GetNewGroupName();
 	void GroupSelectedItems(QModelIndexList &indices);
 	void UngroupSelectedGroups(QModelIndexList &indices);
@@ -112,9 +63,11 @@ private:
 	MacroTree *_mt;
 	std::deque<std::shared_ptr<Macro>> &_macros;
 	bool _hasGroups = false;
+	mutable std::vector<int> _rowToMacroIndex;
+	mutable bool _rowMappingValid = false;
 
 	friend class MacroTree;
-	friend class MacroTreeItem;
+	friend class MacroTreeDelegate;
 };
 
 class MacroTree : public QListView {
@@ -144,15 +97,21 @@ public slots:
 signals:
 	void MacroSelectionChanged();
 
+private slots:
+	void EnableHighlight(bool enable);
+	void MacroRenamed(const QString &, const QString &);
+	void RefreshVisibleItems();
+	void AnimateHighlights();
+
 protected:
 	virtual void dropEvent(QDropEvent *event) override;
 	virtual void paintEvent(QPaintEvent *event) override;
 
 private:
-	MacroTreeItem *GetItemWidget(int idx) const;
-	void ResetWidgets();
-	void UpdateWidget(const QModelIndex &idx, std::shared_ptr<Macro> item);
-	void UpdateWidgets(bool force = false);
+	// Returns a value in the range [0, 1] describing how strongly the
+	// execution of the given macro should still be highlighted
+	double GetHighlightStrength(const Macro *) const;
+	void GetVisibleRows(int &first, int &last) const;
 	void MoveItemBefore(const std::shared_ptr<Macro> &item,
 			    const std::shared_ptr<Macro> &after) const;
 	void MoveItemAfter(const std::shared_ptr<Macro> &item,
@@ -161,17 +120,51 @@ private:
 
 	bool _highlight = false;
 
+	// A single timer is used to refresh the state of all visible items,
+	// so the cost of updating the list does not depend on the number of
+	// macros
+	QTimer _refreshTimer;
+	QTimer _highlightAnimationTimer;
+	std::unordered_map<const Macro *,
+			   std::chrono::high_resolution_clock::time_point>
+		_lastHighlightCheckTimes;
+	std::unordered_map<const Macro *, std::chrono::steady_clock::time_point>
+		_highlightStartTimes;
+	int _firstVisibleRow = -1;
+	std::vector<bool> _visiblePausedState;
+
 	friend class MacroTreeModel;
-	friend class MacroTreeItem;
+	friend class MacroTreeDelegate;
 };
 
 class MacroTreeDelegate : public QStyledItemDelegate {
 	Q_OBJECT
 
 public:
-	MacroTreeDelegate(QObject *parent);
+	MacroTreeDelegate(MacroTree *parent);
+	virtual void paint(QPainter *painter,
+			   const QStyleOptionViewItem &option,
+			   const QModelIndex &index) const override;
 	virtual QSize sizeHint(const QStyleOptionViewItem &option,
 			       const QModelIndex &index) const override;
+
+protected:
+	virtual bool editorEvent(QEvent *event, QAbstractItemModel *model,
+				 const QStyleOptionViewItem &option,
+				 const QModelIndex &index) override;
+
+private:
+	struct Layout {
+		QRect expand;
+		QRect running;
+		QRect icon;
+		QRect text;
+	};
+	Layout GetLayout(const QStyleOptionViewItem &option,
+			 const Macro &macro) const;
+
+	MacroTree *_tree;
+	QIcon _groupIcon;
 };
 
 } // namespace advss
@@ -5,17 +5,38 @@
 #include "macro-action-scene-switch.hpp"
 #include "switcher-data.hpp"
 #include "hotkey.hpp"
+#include "fade-scheduler.hpp"
+#include "task-executor.hpp"
+#include "timer-wheel.hpp"
 
+#include <algorithm>
 #include <limits>
 #undef max
 #include <chrono>
 #include <unordered_map>
+#include <unordered_set>
 #include <QMainWindow>
 
 namespace advss {
 
 constexpr int perfLogThreshold = 300;
 
+// Runs the actions of macros running in parallel
+constexpr size_t actionExecutorThreadCount = 4;
+
+static TimerWheel waitTimers;
+static TaskExecutor actionExecutor(actionExecutorThreadCount);
+
+// Parallel runs which would exceed the configured limit are delayed until
+// another run is done
+static std::mutex runSlotMutex;
+static size_t maxParallelRuns = 0;
+static size_t activeRuns = 0;
+static size_t peakWaitingRuns = 0;
+static std::deque<Macro *> runsWaitingForSlot;
+static std::mutex waitingMacrosMutex;
+static std::unordered_set<Macro *> waitingMacros;
+
 Macro::Macro(const std::string &name, const bool addHotkey)
 {
 	SetName(name);
@@ -31,11 +52,15 @@ Macro::~Macro()
 	Stop();
 	ClearHotkeys();
 
+	if (!switcher) {
+		return;
+	}
 	// Keep the dock widgets in case of shutdown so they can be rostored by
 	// OBS on startup
 	if (!switcher->obsIsShuttingDown) {
 		RemoveDock();
 	}
+	switcher->InvalidateSaveCache();
 }
 
 std::shared_ptr<Macro>
@@ -104,10 +129,13 @@ bool Macro::CeckMatch()
 		return false;
 	}
 
-	_matched = false;
+	// The result is only published once all conditions were checked, as
+	// it is read by other threads without holding the main lock
+	bool matched = false;
 	for (auto &c : _conditions) {
 		if (_paused) {
 			vblog(LOG_INFO, "Macro %s is paused", _name.c_str());
+			_matched = false;
 			return false;
 		}
 
@@ -131,19 +159,19 @@ bool Macro::CeckMatch()
 			      _name.c_str());
 			continue;
 		case LogicType::AND:
-			_matched = _matched && cond;
+			matched = matched && cond;
 			if (cond) {
 				c->SetHighlight();
 			}
 			break;
 		case LogicType::OR:
-			_matched = _matched || cond;
+			matched = matched || cond;
 			if (cond) {
 				c->SetHighlight();
 			}
 			break;
 		case LogicType::AND_NOT:
-			_matched = _matched && !cond;
+			matched = matched && !cond;
 			if (!cond) {
 				c->SetHighlight();
 			}
@@ -154,13 +182,13 @@ bool Macro::CeckMatch()
 			}
 			break;
 		case LogicType::ROOT_NONE:
-			_matched = cond;
+			matched = cond;
 			if (cond) {
 				c->SetHighlight();
 			}
 			break;
 		case LogicType::ROOT_NOT:
-			_matched = !cond;
+			matched = !cond;
 			if (!cond) {
 				c->SetHighlight();
 			}
@@ -174,47 +202,216 @@ bool Macro::CeckMatch()
 		vblog(LOG_INFO, "condition %s returned %d", c->GetId().c_str(),
 		      cond);
 	}
-	vblog(LOG_INFO, "Macro %s returned %d", _name.c_str(), _matched);
+	vblog(LOG_INFO, "Macro %s returned %d", _name.c_str(), matched);
 
-	bool matchedBeforeOnChangeCheck = _matched;
-	if (_matched && _matchOnChange && _lastMatched) {
+	bool matchedBeforeOnChangeCheck = matched;
+	if (matched && _matchOnChange && _lastMatched) {
 		vblog(LOG_INFO, "ignore match for Macro %s (on change)",
 		      _name.c_str());
-		_matched = false;
+		matched = false;
 		SetOnChangeHighlight();
 	}
 	_lastMatched = matchedBeforeOnChangeCheck;
 	_lastCheckTime = std::chrono::high_resolution_clock::now();
-	return _matched;
+	_matched = matched;
+	return matched;
 }
 
 bool Macro::PerformActions(bool forceParallel, bool ignorePause)
 {
-	if (!_done) {
-		vblog(LOG_INFO, "macro %s already running", _name.c_str());
-		return !forceParallel;
+	bool done = true;
+	if (!_done.compare_exchange_strong(done, false)) {
+		switch (QueueRun(ignorePause)) {
+		case QueueResult::QUEUED:
+			vblog(LOG_INFO, "macro %s already running - run queued",
+			      _name.c_str());
+			return true;
+		case QueueResult::DROPPED:
+			vblog(LOG_INFO, "macro %s already running",
+			      _name.c_str());
+			return !forceParallel;
+		case QueueResult::NOT_RUNNING:
+			break;
+		}
 	}
-	_stop = false;
-	_done = false;
+	const bool onExecutor = _runInParallel || forceParallel;
+	StartRun(ignorePause, onExecutor);
 	bool ret = true;
-	if (_runInParallel || forceParallel) {
-		if (_backgroundThread.joinable()) {
-			_backgroundThread.join();
-		}
-		_backgroundThread = std::thread(
-			[this, ignorePause] { RunActions(ignorePause); });
-	} else {
-		RunActions(ret, ignorePause);
+	if (!onExecutor) {
+		ret = ContinueActions(false);
 	}
-	_lastExecutionTime = std::chrono::high_resolution_clock::now();
+	CountRun();
+	return ret;
+}
+
+void Macro::CountRun()
+{
+	const auto now = std::chrono::high_resolution_clock::now();
+	_lastExecutionTime = now;
 	auto group = _parent.lock();
 	if (group) {
-		group->_lastExecutionTime = _lastExecutionTime;
+		group->_lastExecutionTime = now;
 	}
 	if (_runCount != std::numeric_limits<int>::max()) {
 		_runCount++;
 	}
-	return ret;
+}
+
+Macro::QueueResult Macro::QueueRun(bool ignorePause)
+{
+	std::unique_lock<std::mutex> lock(_runMutex);
+	// The previous run might have finished in the meantime
+	if (_done) {
+		_done = false;
+		return QueueResult::NOT_RUNNING;
+	}
+
+	switch (_runPolicy) {
+	case RunPolicy::DROP:
+		break;
+	case RunPolicy::COALESCE:
+		if (_queuedRuns.empty()) {
+			_queuedRuns.push_back(ignorePause);
+		} else {
+			_queuedRuns.back() = ignorePause;
+		}
+		_peakQueuedRuns = std::max<size_t>(_peakQueuedRuns, 1);
+		return QueueResult::QUEUED;
+	case RunPolicy::QUEUE:
+		if (_queuedRuns.size() >= static_cast<size_t>(_maxQueuedRuns)) {
+			break;
+		}
+		_queuedRuns.push_back(ignorePause);
+		_peakQueuedRuns =
+			std::max(_peakQueuedRuns, _queuedRuns.size());
+		return QueueResult::QUEUED;
+	case RunPolicy::RESTART:
+		// The new run is started as soon as the current run noticed
+		// that it was stopped
+		_queuedRuns.assign(1, ignorePause);
+		_peakQueuedRuns = std::max<size_t>(_peakQueuedRuns, 1);
+		_stop = true;
+		lock.unlock();
+		InterruptWait();
+		FadeScheduler::AbortAll(this);
+		return QueueResult::QUEUED;
+	default:
+		break;
+	}
+	++_droppedRuns;
+	return QueueResult::DROPPED;
+}
+
+void Macro::StartRun(bool ignorePause, bool onExecutor)
+{
+	_stop = false;
+	_nextAction = 0;
+	_runResult = true;
+	_ignorePause = ignorePause;
+	_runOnExecutor = onExecutor;
+	if (onExecutor) {
+		PostRun();
+	}
+}
+
+void Macro::PostRun()
+{
+	{
+		std::lock_guard<std::mutex> lock(runSlotMutex);
+		if (maxParallelRuns != 0 && activeRuns >= maxParallelRuns) {
+			runsWaitingForSlot.push_back(this);
+			peakWaitingRuns = std::max(peakWaitingRuns,
+						   runsWaitingForSlot.size());
+			return;
+		}
+		++activeRuns;
+	}
+	actionExecutor.Post([this]() { ContinueActions(false); });
+}
+
+void Macro::ReleaseRunSlot()
+{
+	Macro *next = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(runSlotMutex);
+		// The limit might have been lowered in the meantime
+		if (runsWaitingForSlot.empty() ||
+		    (maxParallelRuns != 0 && activeRuns > maxParallelRuns)) {
+			--activeRuns;
+			return;
+		}
+		// Hand the slot over to the next waiting run
+		next = runsWaitingForSlot.front();
+		runsWaitingForSlot.pop_front();
+	}
+	actionExecutor.Post([next]() { next->ContinueActions(false); });
+}
+
+bool Macro::CancelWaitingRun()
+{
+	std::lock_guard<std::mutex> lock(runSlotMutex);
+	auto it = std::find(runsWaitingForSlot.begin(),
+			    runsWaitingForSlot.end(), this);
+	if (it == runsWaitingForSlot.end()) {
+		return false;
+	}
+	runsWaitingForSlot.erase(it);
+	return true;
+}
+
+void Macro::SetMaxParallelRuns(int limit)
+{
+	std::vector<Macro *> runsToStart;
+	{
+		std::lock_guard<std::mutex> lock(runSlotMutex);
+		maxParallelRuns = limit > 0 ? static_cast<size_t>(limit) : 0;
+		while (!runsWaitingForSlot.empty() &&
+		       (maxParallelRuns == 0 || activeRuns < maxParallelRuns)) {
+			runsToStart.push_back(runsWaitingForSlot.front());
+			runsWaitingForSlot.pop_front();
+			++activeRuns;
+		}
+	}
+	for (auto macro : runsToStart) {
+		actionExecutor.Post(
+			[macro]() { macro->ContinueActions(false); });
+	}
+}
+
+Macro::ParallelRunStats Macro::GetParallelRunStats()
+{
+	std::lock_guard<std::mutex> lock(runSlotMutex);
+	return {activeRuns, runsWaitingForSlot.size(), peakWaitingRuns};
+}
+
+Macro::RunQueueStats Macro::GetRunQueueStats() const
+{
+	std::lock_guard<std::mutex> lock(_runMutex);
+	return {_queuedRuns.size(), _peakQueuedRuns, _droppedRuns};
+}
+
+void Macro::SetRunPolicy(RunPolicy policy)
+{
+	std::lock_guard<std::mutex> lock(_runMutex);
+	_runPolicy = policy;
+}
+
+Macro::RunPolicy Macro::GetRunPolicy() const
+{
+	std::lock_guard<std::mutex> lock(_runMutex);
+	return _runPolicy;
+}
+
+void Macro::SetMaxQueuedRuns(int count)
+{
+	std::lock_guard<std::mutex> lock(_runMutex);
+	_maxQueuedRuns = std::max(count, 1);
+}
+
+int Macro::MaxQueuedRuns() const
+{
+	std::lock_guard<std::mutex> lock(_runMutex);
+	return _maxQueuedRuns;
 }
 
 bool Macro::ExecutedSince(
@@ -237,6 +434,10 @@ int64_t Macro::MsSinceLastCheck() const
 
 void Macro::SetName(const std::string &name)
 {
+	if (_name != name && switcher) {
+		// Other macros might refer to this macro by name
+		switcher->InvalidateSaveCache();
+	}
 	_name = name;
 	SetHotkeysDesc();
 	SetDockWidgetName();
@@ -251,32 +452,145 @@ void Macro::ResetTimers()
 	_lastExecutionTime = {};
 }
 
-void Macro::RunActions(bool &retVal, bool ignorePause)
+bool Macro::ContinueActions(bool resuming)
 {
-	bool ret = true;
-	for (auto &a : _actions) {
-		if (a->Enabled()) {
-			a->LogAction();
-			ret = ret && a->PerformAction();
+	bool resumeResult = true;
+	if (resuming) {
+		TimerWheel::TimerId timer;
+		{
+			std::lock_guard<std::mutex> lock(_runMutex);
+			_suspended = false;
+			_resumed = false;
+			_parked = false;
+			resumeResult = _resumeResult;
+			timer = _resumeTimer;
+			_resumeTimer = 0;
+		}
+		if (timer != 0) {
+			waitTimers.Cancel(timer);
+		}
+		std::lock_guard<std::mutex> lock(waitingMacrosMutex);
+		waitingMacros.erase(this);
+	}
+
+	_runThread = std::this_thread::get_id();
+	while (_nextAction < _actions.size()) {
+		// Queued runs might be started after the macro was stopped
+		if (!resuming && (_stop || _die)) {
+			break;
+		}
+		// Keep the action alive while the run is suspended
+		auto action = _actions[_nextAction];
+		bool ret = true;
+		if (resuming) {
+			resuming = false;
+			ret = resumeResult;
+		} else if (action->Enabled()) {
+			action->LogAction();
+			ret = action->PerformAction();
+			if (Park()) {
+				// The result is only known once it is resumed
+				return true;
+			}
 		} else {
 			vblog(LOG_INFO, "skipping disabled action %s",
-			      a->GetId().c_str());
+			      action->GetId().c_str());
 		}
-		if (!ret || (_paused && !ignorePause) || _stop || _die) {
-			retVal = ret;
+		_nextAction++;
+		_runResult = ret;
+		if (!ret || (_paused && !_ignorePause) || _stop || _die) {
 			break;
 		}
-		if (a->Enabled()) {
-			a->SetHighlight();
+		if (action->Enabled()) {
+			action->SetHighlight();
 		}
 	}
-	_done = true;
+	_runThread = std::thread::id();
+	if (_runOnExecutor) {
+		ReleaseRunSlot();
+	}
+	// Starting a queued run resets the result
+	const bool result = _runResult;
+
+	std::unique_lock<std::mutex> lock(_runMutex);
+	if (_queuedRuns.empty()) {
+		// Notify while holding the lock, as Stop() might return and the
+		// macro be destroyed as soon as the run is done
+		_done = true;
+		_runCv.notify_all();
+		return result;
+	}
+	// The caller requesting a queued run is long gone, so it is always
+	// run on the executor
+	const bool ignorePause = _queuedRuns.front();
+	_queuedRuns.pop_front();
+	lock.unlock();
+	CountRun();
+	StartRun(ignorePause, true);
+	return result;
+}
+
+bool Macro::Park()
+{
+	std::lock_guard<std::mutex> lock(_runMutex);
+	if (!_suspended) {
+		return false;
+	}
+	// The run might be continued on another thread right away
+	_runThread = std::thread::id();
+	// Stop() might have been called before the run was suspended
+	if (!_resumed && (_stop || _die)) {
+		_resumed = true;
+		_resumeResult = false;
+	}
+	_parked = true;
+	if (_resumed) {
+		actionExecutor.Post([this]() { ContinueActions(true); });
+	}
+	return true;
+}
+
+bool Macro::CanSuspend() const
+{
+	return _runOnExecutor && _runThread == std::this_thread::get_id();
+}
+
+void Macro::Suspend(bool abortable)
+{
+	// Adding the macro to the waiting macros first makes sure it cannot
+	// miss InterruptMacroWaits() calls once it is suspended
+	std::lock_guard<std::mutex> waitingLock(waitingMacrosMutex);
+	if (abortable) {
+		waitingMacros.insert(this);
+	}
+	std::lock_guard<std::mutex> lock(_runMutex);
+	_suspended = true;
+	_resumed = false;
+	_parked = false;
+	_resumeResult = true;
+}
+
+void Macro::SuspendUntil(std::chrono::steady_clock::time_point time)
+{
+	Suspend();
+	const auto timer = waitTimers.Schedule(time, [this]() { Resume(); });
+	std::lock_guard<std::mutex> lock(_runMutex);
+	_resumeTimer = timer;
 }
 
-void Macro::RunActions(bool ignorePause)
+void Macro::Resume(bool result)
 {
-	bool unused;
-	RunActions(unused, ignorePause);
+	std::lock_guard<std::mutex> lock(_runMutex);
+	if (!_suspended || _resumed) {
+		return;
+	}
+	_resumed = true;
+	_resumeResult = result;
+	// Otherwise the action which suspended the run did not return yet and
+	// the run will be continued once it does
+	if (_parked) {
+		actionExecutor.Post([this]() { ContinueActions(true); });
+	}
 }
 
 void Macro::SetOnChangeHighlight()
@@ -297,29 +611,75 @@ void Macro::SetPaused(bool pause)
 	_paused = pause;
 }
 
-void Macro::AddHelperThread(std::thread &&newThread)
+void Macro::Stop()
 {
-	for (unsigned int i = 0; i < _helperThreads.size(); i++) {
-		if (!_helperThreads[i].joinable()) {
-			_helperThreads[i] = std::move(newThread);
-			return;
-		}
+	_stop = true;
+	{
+		std::lock_guard<std::mutex> lock(_runMutex);
+		_queuedRuns.clear();
+	}
+	// Runs waiting for a free slot did not start yet
+	if (CancelWaitingRun()) {
+		std::lock_guard<std::mutex> lock(_runMutex);
+		_done = true;
+		_runCv.notify_all();
+		return;
 	}
-	_helperThreads.push_back(std::move(newThread));
+	InterruptWait();
+	FadeScheduler::AbortAll(this);
+
+	// Actions are allowed to stop the macro they are part of
+	if (!_runOnExecutor || _runThread == std::this_thread::get_id()) {
+		return;
+	}
+	// The run might have to be continued on the executor this thread
+	// belongs to
+	TaskExecutor::BlockingScope blocking;
+	std::unique_lock<std::mutex> lock(_runMutex);
+	_runCv.wait(lock, [this]() { return _done.load(); });
 }
 
-void Macro::Stop()
+void Macro::WaitUntil(std::chrono::steady_clock::time_point time)
 {
-	_stop = true;
-	switcher->macroWaitCv.notify_all();
-	for (auto &t : _helperThreads) {
-		if (t.joinable()) {
-			t.join();
+	{
+		std::lock_guard<std::mutex> lock(waitingMacrosMutex);
+		waitingMacros.insert(this);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_waitMutex);
+		_waitExpired = false;
+	}
+	const auto timer = waitTimers.Schedule(time, [this]() {
+		{
+			std::lock_guard<std::mutex> lock(_waitMutex);
+			_waitExpired = true;
 		}
+		_waitCv.notify_all();
+	});
+	{
+		TaskExecutor::BlockingScope blocking;
+		std::unique_lock<std::mutex> lock(_waitMutex);
+		_waitCv.wait(lock, [this]() {
+			return _waitExpired || _stop ||
+			       switcher->abortMacroWait;
+		});
 	}
-	if (_backgroundThread.joinable()) {
-		_backgroundThread.join();
+	waitTimers.Cancel(timer);
+
+	std::lock_guard<std::mutex> lock(waitingMacrosMutex);
+	waitingMacros.erase(this);
+}
+
+void Macro::InterruptWait()
+{
+	// Locking makes sure the waiting thread either already checked the
+	// changed flags or is waiting to be notified
+	{
+		std::lock_guard<std::mutex> lock(_waitMutex);
 	}
+	_waitCv.notify_all();
+	Resume(!switcher->abortMacroWait);
 }
 
 std::deque<std::shared_ptr<MacroCondition>> &Macro::Conditions()
@@ -361,6 +721,8 @@ bool Macro::Save(obs_data_t *obj) const
 	obs_data_set_bool(obj, "pause", _paused);
 	obs_data_set_bool(obj, "parallel", _runInParallel);
 	obs_data_set_bool(obj, "onChange", _matchOnChange);
+	obs_data_set_int(obj, "runPolicy", static_cast<int>(_runPolicy));
+	obs_data_set_int(obj, "maxQueuedRuns", _maxQueuedRuns);
 
 	obs_data_set_bool(obj, "group", _isGroup);
 	if (_isGroup) {
@@ -386,6 +748,53 @@ bool Macro::Save(obs_data_t *obj) const
 	obs_data_set_array(obj, "togglePauseHotkey", togglePauseHotkey);
 	obs_data_array_release(togglePauseHotkey);
 
+	const uint64_t saveGeneration =
+		switcher ? switcher->saveCacheGeneration.load() : 0;
+	if (SegmentsModified(saveGeneration)) {
+		SaveSegments(saveGeneration);
+	}
+	obs_data_set_array(obj, "conditions", _conditionsSaveData);
+	obs_data_set_array(obj, "actions", _actionsSaveData);
+
+	return true;
+}
+
+bool Macro::SegmentsModified(uint64_t saveGeneration) const
+{
+	if (_modified || !switcher || _saveGeneration != saveGeneration) {
+		return true;
+	}
+	obs_data_t *cachedData = obs_data_create();
+	obs_data_set_array(cachedData, "conditions", _conditionsSaveData);
+	obs_data_set_array(cachedData, "actions", _actionsSaveData);
+	const bool refersToChangedSource =
+		switcher->SaveCacheRefersToChangedSource(cachedData);
+	obs_data_release(cachedData);
+	if (refersToChangedSource) {
+		return true;
+	}
+	for (const auto &c : _conditions) {
+		if (c->HasRuntimeSaveData()) {
+			return true;
+		}
+	}
+	for (const auto &a : _actions) {
+		if (a->HasRuntimeSaveData()) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void Macro::SaveSegments(uint64_t saveGeneration) const
+{
+	// The macro shown in the settings window can be modified at any time
+	// so keep it marked as modified until the window is closed.
+	// Reset the flag before serializing to not miss concurrent changes.
+	if (switcher && !switcher->settingsWindowOpened) {
+		_modified = false;
+	}
+
 	obs_data_array_t *conditions = obs_data_array_create();
 	for (auto &c : _conditions) {
 		obs_data_t *array_obj = obs_data_create();
@@ -395,7 +804,7 @@ bool Macro::Save(obs_data_t *obj) const
 
 		obs_data_release(array_obj);
 	}
-	obs_data_set_array(obj, "conditions", conditions);
+	_conditionsSaveData = conditions;
 	obs_data_array_release(conditions);
 
 	obs_data_array_t *actions = obs_data_array_create();
@@ -407,10 +816,10 @@ bool Macro::Save(obs_data_t *obj) const
 
 		obs_data_release(array_obj);
 	}
-	obs_data_set_array(obj, "actions", actions);
+	_actionsSaveData = actions;
 	obs_data_array_release(actions);
 
-	return true;
+	_saveGeneration = saveGeneration;
 }
 
 bool isValidLogic(LogicType t, bool root)
@@ -453,6 +862,14 @@ bool Macro::Load(obs_data_t *obj)
 	_paused = obs_data_get_bool(obj, "pause");
 	_runInParallel = obs_data_get_bool(obj, "parallel");
 	_matchOnChange = obs_data_get_bool(obj, "onChange");
+	// Settings might be modified by hand or come from a newer version
+	_runPolicy = static_cast<RunPolicy>(std::clamp<long long>(
+		obs_data_get_int(obj, "runPolicy"),
+		static_cast<long long>(RunPolicy::DROP),
+		static_cast<long long>(RunPolicy::RESTART)));
+	obs_data_set_default_int(obj, "maxQueuedRuns", 10);
+	_maxQueuedRuns =
+		std::max<int>(obs_data_get_int(obj, "maxQueuedRuns"), 1);
 
 	_isGroup = obs_data_get_bool(obj, "group");
 	if (_isGroup) {
@@ -560,11 +977,7 @@ bool Macro::SwitchesScene() const
 
 bool Macro::OnChangePreventedActionsRecently()
 {
-	if (_onChangeTriggered) {
-		_onChangeTriggered = false;
-		return true;
-	}
-	return false;
+	return _onChangeTriggered.exchange(false);
 }
 
 void Macro::ResetUIHelpers()
@@ -957,6 +1370,7 @@ void SwitcherData::LoadMacros(obs_data_t *obj)
 {
 	Hotkey::ClearAllHotkeys();
 	switcher->macroProperties.Load(obj);
+	Macro::SetMaxParallelRuns(switcher->macroProperties._maxParallelRuns);
 
 	macros.clear();
 	obs_data_array_t *macroArray = obs_data_get_array(obj, "macros");
@@ -964,8 +1378,9 @@ void SwitcherData::LoadMacros(obs_data_t *obj)
 
 	for (size_t i = 0; i < count; i++) {
 		obs_data_t *array_obj = obs_data_array_item(macroArray, i);
-		macros.emplace_back(std::make_shared<Macro>());
-		macros.back()->Load(array_obj);
+		auto macro = std::make_shared<Macro>();
+		macro->Load(array_obj);
+		macros.emplace_back(macro);
 		obs_data_release(array_obj);
 	}
 	obs_data_array_release(macroArray);
@@ -1006,6 +1421,7 @@ void SwitcherData::LoadMacros(obs_data_t *obj)
 		}
 		macros.erase(it);
 	}
+	PublishMacros();
 }
 
 bool SwitcherData::CheckMacros()
@@ -1026,11 +1442,15 @@ bool SwitcherData::CheckMacros()
 
 bool SwitcherData::RunMacros()
 {
-	// Create copy of macor list as elements might be removed, inserted, or
-	// reordered while macros are currently being executed.
+	// Use the published snapshot of the macro list as elements might be
+	// removed, inserted, or reordered while macros are currently being
+	// executed.
 	// For example, this can happen if a macro is performing a wait action,
 	// as the main lock will be unlocked during this time.
-	auto runPhaseMacros = macros;
+	auto runPhaseMacros = GetMacroSnapshot();
+	if (!runPhaseMacros) {
+		return true;
+	}
 
 	// Avoid deadlocks when opening settings window and calling frontend
 	// API functions at the same time.
@@ -1046,7 +1466,7 @@ bool SwitcherData::RunMacros()
 		GetLock()->unlock();
 	}
 
-	for (auto &m : runPhaseMacros) {
+	for (auto &m : *runPhaseMacros) {
 		if (m && m->Matched()) {
 			vblog(LOG_INFO, "running macro: %s", m->Name().c_str());
 			if (!m->PerformActions()) {
@@ -1061,6 +1481,23 @@ bool SwitcherData::RunMacros()
 	return true;
 }
 
+std::shared_ptr<const std::deque<std::shared_ptr<Macro>>>
+SwitcherData::GetMacroSnapshot() const
+{
+	return std::atomic_load(&macroSnapshot);
+}
+
+void SwitcherData::PublishMacros()
+{
+	// Only the UI thread modifies the macro list, so it is safe to read it
+	// here without holding the main lock
+	std::atomic_store(
+		&macroSnapshot,
+		std::shared_ptr<const std::deque<std::shared_ptr<Macro>>>(
+			std::make_shared<std::deque<std::shared_ptr<Macro>>>(
+				macros)));
+}
+
 Macro *GetMacroByName(const char *name)
 {
 	for (auto &m : switcher->macros) {
@@ -1088,4 +1525,12 @@ std::weak_ptr<Macro> GetWeakMacroByName(const char *name)
 	return {};
 }
 
+void InterruptMacroWaits()
+{
+	std::lock_guard<std::mutex> lock(waitingMacrosMutex);
+	for (auto macro : waitingMacros) {
+		macro->InterruptWait();
+	}
+}
+
 } // namespace advss
@@ -6,9 +6,13 @@
 
 #include <QString>
 #include <QByteArray>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <string>
 #include <deque>
 #include <memory>
+#include <mutex>
 #include <map>
 #include <thread>
 #include <obs.hpp>
@@ -33,6 +37,39 @@ public:
 	void SetName(const std::string &name);
 	void SetRunInParallel(bool parallel) { _runInParallel = parallel; }
 	bool RunInParallel() const { return _runInParallel; }
+
+	// Controls what happens if the macro is run while it is still running
+	enum class RunPolicy {
+		DROP,
+		// Run only once more afterwards, however often it was triggered
+		COALESCE,
+		// Run once more afterwards for each request, up to a limit
+		QUEUE,
+		// Stop the current run and start over
+		RESTART,
+	};
+	void SetRunPolicy(RunPolicy);
+	RunPolicy GetRunPolicy() const;
+	void SetMaxQueuedRuns(int);
+	int MaxQueuedRuns() const;
+	struct RunQueueStats {
+		size_t queued = 0;
+		size_t peakQueued = 0;
+		uint64_t dropped = 0;
+	};
+	RunQueueStats GetRunQueueStats() const;
+
+	// Limits the number of parallel runs of all macros, which can be in
+	// progress at the same time, including runs suspended by their actions.
+	// Additional runs are delayed until another run is done.
+	// A limit of 0 disables the limit.
+	static void SetMaxParallelRuns(int);
+	struct ParallelRunStats {
+		size_t active = 0;
+		size_t waiting = 0;
+		size_t peakWaiting = 0;
+	};
+	static ParallelRunStats GetParallelRunStats();
 	void SetPaused(bool pause = true);
 	bool Paused() const { return _paused; }
 	void SetMatchOnChange(bool onChange) { _matchOnChange = onChange; }
@@ -40,9 +77,24 @@ public:
 	int RunCount() const { return _runCount; };
 	void ResetRunCount() { _runCount = 0; };
 	void ResetTimers();
-	void AddHelperThread(std::thread &&);
 	bool GetStop() const { return _stop; }
 	void Stop();
+	// Blocks until the given time is reached, the macro is stopped or
+	// all macro waits are aborted
+	void WaitUntil(std::chrono::steady_clock::time_point);
+	void InterruptWait();
+
+	// Actions of macros running on the action executor can suspend the run
+	// instead of blocking while waiting for something.
+	// The remaining actions are run once Resume() is called and the result
+	// passed to it replaces the value returned by PerformAction().
+	// Stopping the macro or aborting all macro waits resumes the run.
+	// Runs which are not abortable are only resumed by stopping the macro,
+	// e.g. while waiting for a fade to complete.
+	bool CanSuspend() const;
+	void Suspend(bool abortable = true);
+	void SuspendUntil(std::chrono::steady_clock::time_point);
+	void Resume(bool result = true);
 
 	std::deque<std::shared_ptr<MacroCondition>> &Conditions();
 	std::deque<std::shared_ptr<MacroAction>> &Actions();
@@ -70,6 +122,9 @@ public:
 	// Saving and loading
 	bool Save(obs_data_t *obj) const;
 	bool Load(obs_data_t *obj);
+	// The serialized conditions and actions are reused by Save() until the
+	// macro is marked as modified
+	void SetModified() { _modified = true; }
 	// Some macros can refer to other macros, which are not yet loaded.
 	// Use this function to set these references after loading is complete.
 	bool PostLoad();
@@ -111,44 +166,85 @@ private:
 	void SetupHotkeys();
 	void ClearHotkeys() const;
 	void SetHotkeysDesc() const;
-	void RunActions(bool &ret, bool ignorePause);
-	void RunActions(bool ignorePause);
+	enum class QueueResult { QUEUED, DROPPED, NOT_RUNNING };
+	QueueResult QueueRun(bool ignorePause);
+	void StartRun(bool ignorePause, bool onExecutor);
+	void PostRun();
+	static void ReleaseRunSlot();
+	bool CancelWaitingRun();
+	void CountRun();
+	// Returns the result of the run unless it was suspended
+	bool ContinueActions(bool resuming);
+	bool Park();
 	void SetOnChangeHighlight();
 	bool DockIsVisible() const;
 	void SetDockWidgetName() const;
+	bool SegmentsModified(uint64_t saveGeneration) const;
+	void SaveSegments(uint64_t saveGeneration) const;
 	void SaveDockSettings(obs_data_t *obj) const;
 	void LoadDockSettings(obs_data_t *obj);
 	void RemoveDock();
 
 	std::string _name = "";
-	bool _die = false;
-	bool _stop = false;
-	bool _done = true;
+	// Runtime state which is accessed without holding the main lock
+	std::atomic_bool _die = {false};
+	std::atomic_bool _stop = {false};
+	std::atomic_bool _done = {true};
 	std::chrono::high_resolution_clock::time_point _lastCheckTime{};
-	std::chrono::high_resolution_clock::time_point _lastExecutionTime{};
-	std::thread _backgroundThread;
-	std::vector<std::thread> _helperThreads;
+	// Also updated by runs started on the action executor
+	std::atomic<std::chrono::high_resolution_clock::time_point>
+		_lastExecutionTime{};
+	std::mutex _waitMutex;
+	std::condition_variable _waitCv;
+	bool _waitExpired = false;
+
+	// State of the current run, which might be continued on another thread
+	// once a suspended action is resumed
+	size_t _nextAction = 0;
+	bool _runResult = true;
+	bool _ignorePause = false;
+	std::atomic_bool _runOnExecutor = {false};
+	std::atomic<std::thread::id> _runThread;
+	mutable std::mutex _runMutex;
+	std::condition_variable _runCv;
+	bool _suspended = false;
+	bool _resumed = false;
+	bool _parked = false;
+	bool _resumeResult = true;
+	uint64_t _resumeTimer = 0;
+
+	RunPolicy _runPolicy = RunPolicy::DROP;
+	int _maxQueuedRuns = 10;
+	// Stores if the pause state should be ignored for each queued run
+	std::deque<bool> _queuedRuns;
+	size_t _peakQueuedRuns = 0;
+	uint64_t _droppedRuns = 0;
 
 	std::deque<std::shared_ptr<MacroCondition>> _conditions;
 	std::deque<std::shared_ptr<MacroAction>> _actions;
 
+	mutable std::atomic_bool _modified = {true};
+	mutable uint64_t _saveGeneration = 0;
+	mutable OBSDataArray _conditionsSaveData;
+	mutable OBSDataArray _actionsSaveData;
+
 	std::weak_ptr<Macro> _parent;
 	uint32_t _groupSize = 0;
 	bool _isGroup = false;
 	bool _isCollapsed = false;
 
 	bool _runInParallel = false;
-	bool _matched = false;
+	std::atomic_bool _matched = {false};
 	bool _lastMatched = false;
 	bool _matchOnChange = true;
-	bool _paused = false;
-	int _runCount = 0;
+	std::atomic_bool _paused = {false};
+	std::atomic_int _runCount = {0};
 	bool _registerHotkeys = true;
 	obs_hotkey_id _pauseHotkey = OBS_INVALID_HOTKEY_ID;
 	obs_hotkey_id _unpauseHotkey = OBS_INVALID_HOTKEY_ID;
 	obs_hotkey_id _togglePauseHotkey = OBS_INVALID_HOTKEY_ID;
 
-	bool _onChangeTriggered = false;
+	std::atomic_bool _onChangeTriggered = {false};
 
 	bool _registerDock = false;
 	bool _dockHasRunButton = true;
@@ -176,5 +272,6 @@ private:
 Macro *GetMacroByName(const char *name);
 Macro *GetMacroByQString(const QString &name);
 std::weak_ptr<Macro> GetWeakMacroByName(const char *name);
+void InterruptMacroWaits();
 
 } // namespace advss
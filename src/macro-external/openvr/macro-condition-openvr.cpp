@@ -220,9 +220,9 @@ MacroConditionOpenVREdit::MacroConditionOpenVREdit(
 	mainLayout->addWidget(_errLabel);
 	setLayout(mainLayout);
 
-	connect(&_timer, &QTimer::timeout, this,
-		&MacroConditionOpenVREdit::UpdateOpenVRPos);
-	_timer.start(1000);
+	RegisterUIRefresh(this, [this](const UIRefreshSnapshot &) {
+		UpdateOpenVRPos();
+	});
 
 	_entryData = entryData;
 	UpdateEntryData();
@@ -1,10 +1,10 @@
 #pragma once
 #include <macro.hpp>
+#include <ui-refresh.hpp>
 #include <variable-spinbox.hpp>
 
 #include <QComboBox>
 #include <QPushButton>
-#include <QTimer>
 
 namespace advss {
 
@@ -67,7 +67,6 @@ protected:
 	std::shared_ptr<MacroConditionOpenVR> _entryData;
 
 private:
-	QTimer _timer;
 	bool _loading = true;
 };
 
@@ -114,6 +114,10 @@ bool MacroConditionVideo::CheckShouldBeSkipped()
 	}
 
 	if (_throttleEnabled) {
+		// Checks done ahead of the regular interval do not count
+		if (GetSwitcher()->deadlineCheck) {
+			return true;
+		}
 		if (_runCount <= _throttleCount) {
 			_runCount++;
 			return true;
@@ -433,9 +437,9 @@ BrightnessEdit::BrightnessEdit(QWidget *parent,
 		this,
 		SLOT(BrightnessThresholdChanged(
 			const NumberVariable<double> &)));
-	QWidget::connect(&_timer, &QTimer::timeout, this,
-			 &BrightnessEdit::UpdateCurrentBrightness);
-	_timer.start(1000);
+	RegisterUIRefresh(this, [this](const UIRefreshSnapshot &) {
+		UpdateCurrentBrightness();
+	});
 
 	_threshold->SetDoubleValue(_data->_brightnessThreshold);
 	_loading = false;
@@ -8,6 +8,7 @@
 #include <file-selection.hpp>
 #include <screenshot-helper.hpp>
 #include <slider-spinbox.hpp>
+#include <ui-refresh.hpp>
 #include <variable-text-edit.hpp>
 #include <variable-line-edit.hpp>
 
@@ -102,7 +103,6 @@ private slots:
 private:
 	SliderSpinBox *_threshold;
 	QLabel *_current;
-	QTimer _timer;
 
 	std::shared_ptr<MacroConditionVideo> _data;
 	bool _loading = true;
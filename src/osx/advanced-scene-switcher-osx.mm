@@ -17,9 +17,12 @@ namespace advss {
 
 bool canSimulateKeyPresses = false;
 
-std::chrono::high_resolution_clock::time_point lastMouseLeftClickTime{};
-std::chrono::high_resolution_clock::time_point lastMouseMiddleClickTime{};
-std::chrono::high_resolution_clock::time_point lastMouseRightClickTime{};
+std::atomic<std::chrono::high_resolution_clock::time_point>
+	lastMouseLeftClickTime{};
+std::atomic<std::chrono::high_resolution_clock::time_point>
+	lastMouseMiddleClickTime{};
+std::atomic<std::chrono::high_resolution_clock::time_point>
+	lastMouseRightClickTime{};
 
 void GetWindowList(std::vector<std::string> &windows)
 {
@@ -280,6 +283,12 @@ int SecondsSinceLastInput()
 	return (int)time;
 }
 
+std::optional<std::pair<int, int>> GetTrackedCursorPos()
+{
+	// Not implemented
+	return {};
+}
+
 void GetProcessList(QStringList &list)
 {
 	list.clear();
@@ -459,7 +468,7 @@ static std::map<HotkeyType, CGKeyCode> keyTable = {
 	{HotkeyType::Key_NumpadEnter, kVK_ANSI_KeypadEnter},
 };
 
-void PressKeys(const std::vector<HotkeyType> keys, int duration)
+void SendKeyEvents(const std::vector<KeyEvent> &events)
 {
 	// TODO:
 	// I can't seem to get this to work so drop support for this functionality
@@ -2,6 +2,7 @@
 #include <vector>
 #include <string>
 #include <QStringList>
+#include <atomic>
 #include <chrono>
 #include <optional>
 
@@ -9,10 +10,18 @@ namespace advss {
 
 enum class HotkeyType;
 
-// TODO: Implement for MacOS and Linux
-extern std::chrono::high_resolution_clock::time_point lastMouseLeftClickTime;
-extern std::chrono::high_resolution_clock::time_point lastMouseMiddleClickTime;
-extern std::chrono::high_resolution_clock::time_point lastMouseRightClickTime;
+struct KeyEvent {
+	HotkeyType key;
+	bool pressed;
+};
+
+// TODO: Implement for MacOS
+extern std::atomic<std::chrono::high_resolution_clock::time_point>
+	lastMouseLeftClickTime;
+extern std::atomic<std::chrono::high_resolution_clock::time_point>
+	lastMouseMiddleClickTime;
+extern std::atomic<std::chrono::high_resolution_clock::time_point>
+	lastMouseRightClickTime;
 
 void GetWindowList(std::vector<std::string> &windows);
 void GetWindowList(QStringList &windows);
@@ -21,10 +30,14 @@ bool IsFullscreen(const std::string &title);
 bool IsMaximized(const std::string &title);
 std::optional<std::string> GetTextInWindow(const std::string &window);
 int SecondsSinceLastInput();
+// Returns the cursor position in native pixels if the platform keeps track of
+// it, so it does not have to be queried
+std::optional<std::pair<int, int>> GetTrackedCursorPos();
 void GetProcessList(QStringList &processes);
 void GetForegroundProcessName(std::string &name);
 bool IsInFocus(const QString &executable);
-void PressKeys(const std::vector<HotkeyType> keys, int duration);
+// Sends all events in the given order and flushes them only once
+void SendKeyEvents(const std::vector<KeyEvent> &events);
 void PlatformInit();
 void PlatformCleanup();
 
@@ -56,8 +56,9 @@ StatusControl::StatusControl(QWidget *parent, bool noLayout)
 	} else {
 		SetStarted();
 	}
-	connect(&_timer, SIGNAL(timeout()), this, SLOT(UpdateStatus()));
-	_timer.start(1000);
+	RegisterUIRefresh(this, [this](const UIRefreshSnapshot &snapshot) {
+		UpdateStatus(snapshot);
+	});
 }
 
 void StatusControl::ButtonClicked()
@@ -71,13 +72,13 @@ void StatusControl::ButtonClicked()
 	}
 }
 
-void StatusControl::UpdateStatus()
+void StatusControl::UpdateStatus(const UIRefreshSnapshot &snapshot)
 {
 	if (!switcher) {
 		return;
 	}
 
-	if (switcher->th && switcher->th->isRunning()) {
+	if (snapshot.switcherRunning) {
 		if (!_setToStopped) {
 			return;
 		}
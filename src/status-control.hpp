@@ -1,9 +1,9 @@
 #pragma once
 #include "obs-dock.hpp"
+#include "ui-refresh.hpp"
 
 #include <QPushButton>
 #include <QLabel>
-#include <QTimer>
 #include <QLayout>
 #include <obs-data.h>
 
@@ -21,9 +21,9 @@ public:
 
 private slots:
 	void ButtonClicked();
-	void UpdateStatus();
 
 private:
+	void UpdateStatus(const UIRefreshSnapshot &);
 	void SetStopped();
 	void SetStarted();
 
@@ -31,7 +31,6 @@ private:
 	QHBoxLayout *_buttonLayout;
 	QLabel *_status;
 	QLabel *_statusPrefix;
-	QTimer _timer;
 	QMetaObject::Connection _pulse;
 
 	bool _setToStopped = true;
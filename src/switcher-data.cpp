@@ -61,6 +61,7 @@ void SwitcherData::Prune()
 		if (!s.valid()) {
 			screenRegionSwitches.erase(
 				screenRegionSwitches.begin() + i--);
+			screenRegionsChanged = true;
 		}
 	}
 
@@ -17,10 +17,14 @@
 #include "switch-network.hpp"
 
 #include "macro-properties.hpp"
+#include "async-file-writer.hpp"
 #include "duration-control.hpp"
 #include "curl-helper.hpp"
 #include "priority-helper.hpp"
+#include "region-index.hpp"
 #include "log-helper.hpp"
+#include "multi-pattern-matcher.hpp"
+#include "window-title-filter.hpp"
 
 #include <condition_variable>
 #include <vector>
@@ -83,6 +87,14 @@ public:
 	void SaveHotkeys(obs_data_t *obj);
 	void SaveUISettings(obs_data_t *obj);
 	void SaveVersion(obs_data_t *obj, const std::string &currentVersion);
+	void SaveLegacySwitches(obs_data_t *obj);
+	// Has to be called whenever the name of something settings might refer
+	// to changes, as all cached serialized settings have to be recreated
+	void InvalidateSaveCache() { ++saveCacheGeneration; }
+	// Only cached settings mentioning the given source name are recreated
+	void InvalidateSaveCache(const std::string &sourceName);
+	// Has to be called while saving the settings
+	bool SaveCacheRefersToChangedSource(obs_data_t *cachedData) const;
 
 	void LoadSettings(obs_data_t *obj);
 	void LoadMacros(obs_data_t *obj);
@@ -108,12 +120,20 @@ public:
 	std::unique_lock<std::mutex> *mainLoopLock = nullptr;
 	bool stop = false;
 	std::condition_variable cv;
-	std::condition_variable macroWaitCv;
 	std::atomic_bool abortMacroWait = {false};
 	std::condition_variable macroTransitionCv;
 
 	std::vector<std::function<void()>> resetForNextIntervalFuncs;
 
+	std::shared_ptr<const std::deque<std::shared_ptr<Macro>>> macroSnapshot;
+
+	std::atomic<uint64_t> saveCacheGeneration = {0};
+	std::mutex changedSourceNamesMutex;
+	std::vector<std::string> changedSourceNames;
+	std::vector<std::string> savedChangedSourceNames;
+	uint64_t legacySwitchesSaveGeneration = 0;
+	OBSData legacySwitchesSaveData;
+
 	bool firstBoot = true;
 	bool transitionActive = false;
 	bool sceneColletionStop = false;
@@ -121,6 +141,9 @@ public:
 	bool obsIsShuttingDown = false;
 	bool firstInterval = true;
 	bool firstIntervalAfterStop = true;
+	// Set if the current check was done ahead of the regular interval, as a
+	// time based condition was due
+	bool deadlineCheck = false;
 	int shutdownConditionCount = 0;
 	bool startupLoadDone = false;
 
@@ -157,15 +180,15 @@ public:
 
 	/* --- End of General tab section --- */
 
-	struct AudioFadeInfo {
-		std::atomic_bool active = {false};
-		std::atomic_int id = {0};
-	};
-	AudioFadeInfo masterAudioFade;
-	std::unordered_map<std::string, AudioFadeInfo> activeAudioFades;
-
 	MacroProperties macroProperties;
 	std::deque<std::shared_ptr<Macro>> macros;
+	// Immutable copy of the macro list, which can be used without holding
+	// the main lock.
+	// PublishMacros() has to be called from the UI thread whenever macros
+	// are added, removed, or reordered.
+	std::shared_ptr<const std::deque<std::shared_ptr<Macro>>>
+	GetMacroSnapshot() const;
+	void PublishMacros();
 	bool macroSceneSwitched = false;
 
 	Curlhelper curl;
@@ -267,6 +290,7 @@ public:
 			 int &delay);
 	bool checkMediaSwitch(OBSWeakSource &scene, OBSWeakSource &transition);
 	bool checkTimeSwitch(OBSWeakSource &scene, OBSWeakSource &transition);
+	void scheduleTimeSwitches(const QDateTime &now);
 	bool checkAudioSwitch(OBSWeakSource &scene, OBSWeakSource &transition);
 	void checkAudioSwitchFallback(OBSWeakSource &scene,
 				      OBSWeakSource &transition);
@@ -279,18 +303,25 @@ public:
 	void checkSwitchCooldown(bool &match);
 
 	std::deque<WindowSwitch> windowSwitches;
+	MultiPatternMatcher windowSwitchMatcher;
 	std::vector<std::string> ignoreWindowsSwitches;
+	WindowTitleFilter ignoreWindowsFilter;
 	IdleData idleData;
 	std::vector<std::string> ignoreIdleWindows;
+	WindowTitleFilter ignoreIdleWindowsFilter;
 	bool showFrame = false;
 	std::deque<ScreenRegionSwitch> screenRegionSwitches;
+	RegionIndex screenRegionIndex;
+	bool screenRegionsChanged = true;
 	bool uninterruptibleSceneSequenceActive = false;
 	std::deque<SceneSequenceSwitch> sceneSequenceSwitches;
 	std::deque<RandomSwitch> randomSwitches;
 	OBSWeakSource lastRandomScene;
 	FileIOData fileIO;
+	AsyncFileWriter statusFileWriter;
 	std::deque<FileSwitch> fileSwitches;
 	std::deque<ExecutableSwitch> executableSwitches;
+	MultiPatternMatcher executableSwitchMatcher;
 	std::deque<SceneTrigger> sceneTriggers;
 	std::deque<SceneTransition> sceneTransitions;
 	std::deque<DefaultSceneTransition> defaultSceneTransitions;
@@ -298,6 +329,7 @@ public:
 	std::deque<PauseEntry> pauseEntries;
 	std::deque<TimeSwitch> timeSwitches;
 	QDateTime liveTime;
+	QDateTime lastTimeSwitchCheck;
 	std::deque<AudioSwitch> audioSwitches;
 	AudioSwitchFallback audioFallback;
 	WSServer server;
@@ -0,0 +1,68 @@
+#include "allocation-counter.hpp"
+
+#ifdef ADVSS_COUNT_ALLOCATIONS
+#include <cstdlib>
+#include <new>
+
+static thread_local uint64_t allocationCount = 0;
+
+void *operator new(std::size_t size)
+{
+	++allocationCount;
+	if (size == 0) {
+		size = 1;
+	}
+	void *ptr = std::malloc(size);
+	if (!ptr) {
+		throw std::bad_alloc();
+	}
+	return ptr;
+}
+
+void *operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+	std::free(ptr);
+}
+#endif
+
+namespace advss {
+
+bool AllocationCountingEnabled()
+{
+#ifdef ADVSS_COUNT_ALLOCATIONS
+	return true;
+#else
+	return false;
+#endif
+}
+
+uint64_t GetThreadAllocationCount()
+{
+#ifdef ADVSS_COUNT_ALLOCATIONS
+	return allocationCount;
+#else
+	return 0;
+#endif
+}
+
+} // namespace advss
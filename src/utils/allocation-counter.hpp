@@ -0,0 +1,23 @@
+#pragma once
+#include <cstdint>
+
+namespace advss {
+
+// Heap allocations are only counted if the plugin was built with the
+// ADVSS_COUNT_ALLOCATIONS option, as this requires replacing the global
+// operator new.
+// It is meant to verify that the steady state of the switcher thread does
+// not allocate.
+//
+// Only allocations of this library using operator new are counted.
+// Allocations of Qt and OBS use malloc() and are not counted, neither are
+// allocations made within other libraries, for example by non-inline
+// functions of the C++ standard library.
+// On Linux the library is linked with -Bsymbolic-functions, as the
+// replacement would otherwise be interposed by the operator new of the
+// already loaded C++ standard library and nothing would be counted.
+bool AllocationCountingEnabled();
+// Number of heap allocations performed by the calling thread so far
+uint64_t GetThreadAllocationCount();
+
+} // namespace advss
@@ -0,0 +1,91 @@
+#include "async-file-writer.hpp"
+#include "log-helper.hpp"
+
+#include <QSaveFile>
+
+namespace advss {
+
+// Gives bursts of updates the chance to be combined into a single write
+constexpr auto coalesceDelay = std::chrono::milliseconds(50);
+
+AsyncFileWriter::~AsyncFileWriter()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_cv.notify_all();
+	if (_thread.joinable()) {
+		_thread.join();
+	}
+}
+
+void AsyncFileWriter::Write(const std::string &path,
+			    const std::string &content)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (path == _lastPath && content == _lastContent) {
+			return;
+		}
+		_lastPath = path;
+		_lastContent = content;
+		_path = path;
+		_content = content;
+		_pending = true;
+		if (!_thread.joinable()) {
+			_thread = std::thread(&AsyncFileWriter::Thread, this);
+		}
+	}
+	_cv.notify_all();
+}
+
+static bool writeFile(const std::string &path, const std::string &content)
+{
+	// QSaveFile writes to a temporary file which replaces the target file
+	// once all data was written successfully
+	QSaveFile file(QString::fromStdString(path));
+	if (!file.open(QIODevice::WriteOnly)) {
+		return false;
+	}
+	if (file.write(content.data(), content.size()) !=
+	    static_cast<qint64>(content.size())) {
+		// The target file is left untouched if commit() is not called
+		return false;
+	}
+	return file.commit();
+}
+
+void AsyncFileWriter::Thread()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (true) {
+		_cv.wait(lock, [this]() { return _stop || _pending; });
+		if (!_pending) {
+			return;
+		}
+		if (!_stop) {
+			_cv.wait_for(lock, coalesceDelay,
+				     [this]() { return _stop; });
+		}
+
+		const std::string path = std::move(_path);
+		const std::string content = std::move(_content);
+		_pending = false;
+
+		lock.unlock();
+		const bool success = writeFile(path, content);
+		lock.lock();
+
+		if (!success) {
+			blog(LOG_WARNING, "failed to write to file \"%s\"",
+			     path.c_str());
+			// Otherwise writing the same content again would be
+			// skipped and the file would stay outdated
+			_lastPath.clear();
+			_lastContent.clear();
+		}
+	}
+}
+
+} // namespace advss
@@ -0,0 +1,37 @@
+#pragma once
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace advss {
+
+// Writes files on a separate thread, so the caller never blocks on disk I/O.
+// Content is only written if it differs from the previously requested one.
+// If it changes faster than it can be written, only the most recent content
+// is written.
+// Files are replaced atomically, so readers never see partial writes.
+class AsyncFileWriter {
+public:
+	AsyncFileWriter() = default;
+	~AsyncFileWriter();
+	AsyncFileWriter(const AsyncFileWriter &) = delete;
+	AsyncFileWriter &operator=(const AsyncFileWriter &) = delete;
+
+	void Write(const std::string &path, const std::string &content);
+
+private:
+	void Thread();
+
+	std::thread _thread;
+	std::mutex _mutex;
+	std::condition_variable _cv;
+	bool _stop = false;
+	bool _pending = false;
+	std::string _path;
+	std::string _content;
+	std::string _lastPath;
+	std::string _lastContent;
+};
+
+} // namespace advss
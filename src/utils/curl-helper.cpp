@@ -1,4 +1,5 @@
 #include "curl-helper.hpp"
+#include "task-executor.hpp"
 
 #include <QDir>
 #include <QFileInfo>
@@ -47,6 +48,7 @@ CURLcode Curlhelper::Perform()
 	if (!_initialized) {
 		return CURLE_FAILED_INIT;
 	}
+	TaskExecutor::BlockingScope blocking;
 	return _perform(_curl);
 }
 
@@ -0,0 +1,56 @@
+#include "deadline-scheduler.hpp"
+
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <QDateTime>
+
+namespace advss {
+
+static std::mutex schedulerMutex;
+// Ordered by time, so the next deadline can be found without checking all
+static std::set<std::pair<int64_t, const void *>> deadlines;
+static std::unordered_map<const void *, int64_t> deadlineOfOwner;
+
+void DeadlineScheduler::Set(const void *owner, int64_t msSinceEpoch)
+{
+	std::lock_guard<std::mutex> lock(schedulerMutex);
+	auto it = deadlineOfOwner.find(owner);
+	if (it != deadlineOfOwner.end()) {
+		if (it->second == msSinceEpoch) {
+			return;
+		}
+		deadlines.erase({it->second, owner});
+		it->second = msSinceEpoch;
+	} else {
+		deadlineOfOwner.emplace(owner, msSinceEpoch);
+	}
+	deadlines.emplace(msSinceEpoch, owner);
+}
+
+void DeadlineScheduler::Remove(const void *owner)
+{
+	std::lock_guard<std::mutex> lock(schedulerMutex);
+	auto it = deadlineOfOwner.find(owner);
+	if (it == deadlineOfOwner.end()) {
+		return;
+	}
+	deadlines.erase({it->second, owner});
+	deadlineOfOwner.erase(it);
+}
+
+std::optional<std::chrono::milliseconds>
+DeadlineScheduler::TimeUntilNextDeadline()
+{
+	const auto now = QDateTime::currentMSecsSinceEpoch();
+	std::lock_guard<std::mutex> lock(schedulerMutex);
+	// Deadlines which already passed belong to conditions which were not
+	// checked since, e.g. because their macro is paused, so skip them
+	auto it = deadlines.lower_bound({now + 1, nullptr});
+	if (it == deadlines.end()) {
+		return {};
+	}
+	return std::chrono::milliseconds(it->first - now);
+}
+
+} // namespace advss
@@ -0,0 +1,21 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+namespace advss {
+
+// Keeps track of the points in time at which time based conditions will match
+// next, so the switcher thread can wake up exactly when one of them is due
+// instead of only on its regular interval.
+// Deadlines are given in milliseconds since epoch and are identified by their
+// owner, which can only register a single deadline at a time.
+class DeadlineScheduler {
+public:
+	static void Set(const void *owner, int64_t msSinceEpoch);
+	static void Remove(const void *owner);
+	// Returns the time until the earliest deadline which has not yet passed
+	static std::optional<std::chrono::milliseconds> TimeUntilNextDeadline();
+};
+
+} // namespace advss
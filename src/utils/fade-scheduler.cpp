@@ -0,0 +1,203 @@
+#include "fade-scheduler.hpp"
+#include "task-executor.hpp"
+
+#include <obs.hpp>
+#include <unordered_map>
+
+namespace advss {
+
+static std::mutex fadeMutex;
+static std::unordered_map<std::string, std::shared_ptr<Fade>> fades;
+// Must never be locked while holding fadeMutex, as OBS holds its own lock
+// while calling Tick()
+static std::mutex tickCallbackMutex;
+static bool tickCallbackRegistered = false;
+
+static void registerTickCallback(void (*tick)(void *, float))
+{
+	std::lock_guard<std::mutex> lock(tickCallbackMutex);
+	if (!tickCallbackRegistered) {
+		obs_add_tick_callback(tick, nullptr);
+		tickCallbackRegistered = true;
+	}
+}
+
+double ApplyFadeCurve(FadeCurve curve, double progress)
+{
+	if (progress <= 0.) {
+		return 0.;
+	}
+	if (progress >= 1.) {
+		return 1.;
+	}
+
+	switch (curve) {
+	case FadeCurve::LINEAR:
+		return progress;
+	case FadeCurve::EASE_IN:
+		return progress * progress;
+	case FadeCurve::EASE_OUT:
+		return 1. - (1. - progress) * (1. - progress);
+	case FadeCurve::EASE_IN_OUT:
+		return progress * progress * (3. - 2. * progress);
+	default:
+		break;
+	}
+	return progress;
+}
+
+void Fade::Wait()
+{
+	TaskExecutor::BlockingScope blocking;
+	std::unique_lock<std::mutex> lock(_mutex);
+	_cv.wait(lock, [this]() { return _done; });
+}
+
+void Fade::OnDone(std::function<void()> callback)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	if (!_done) {
+		_onDone.emplace_back(std::move(callback));
+		return;
+	}
+	lock.unlock();
+	callback();
+}
+
+bool Fade::Done()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _done;
+}
+
+void Fade::SetDone()
+{
+	std::vector<std::function<void()>> callbacks;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_done = true;
+		callbacks.swap(_onDone);
+	}
+	_cv.notify_all();
+	for (const auto &callback : callbacks) {
+		callback();
+	}
+}
+
+std::shared_ptr<Fade>
+FadeScheduler::Start(const std::string &key, const void *owner, double from,
+		     double to, std::chrono::milliseconds duration,
+		     FadeCurve curve, const SetValueFunc &setValue,
+		     bool abortActive)
+{
+	std::unique_lock<std::mutex> lock(fadeMutex);
+	auto it = fades.find(key);
+	if (it != fades.end()) {
+		if (!abortActive) {
+			return nullptr;
+		}
+		it->second->SetDone();
+		fades.erase(it);
+	}
+
+	auto fade = std::make_shared<Fade>();
+	fade->_key = key;
+	fade->_owner = owner;
+	fade->_from = from;
+	fade->_to = to;
+	fade->_start = std::chrono::steady_clock::now();
+	fade->_end = fade->_start + duration;
+	fade->_curve = curve;
+	fade->_setValue = setValue;
+
+	if (duration.count() <= 0 || from == to) {
+		setValue(to);
+		fade->SetDone();
+		return fade;
+	}
+
+	fades.emplace(key, fade);
+	lock.unlock();
+	registerTickCallback(Tick);
+	return fade;
+}
+
+bool FadeScheduler::IsActive(const std::string &key)
+{
+	std::lock_guard<std::mutex> lock(fadeMutex);
+	return fades.find(key) != fades.end();
+}
+
+void FadeScheduler::Abort(const std::string &key)
+{
+	std::lock_guard<std::mutex> lock(fadeMutex);
+	auto it = fades.find(key);
+	if (it == fades.end()) {
+		return;
+	}
+	it->second->SetDone();
+	fades.erase(it);
+}
+
+void FadeScheduler::AbortAll(const void *owner)
+{
+	std::lock_guard<std::mutex> lock(fadeMutex);
+	for (auto it = fades.begin(); it != fades.end();) {
+		if (it->second->_owner == owner) {
+			it->second->SetDone();
+			it = fades.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+void FadeScheduler::Cleanup()
+{
+	{
+		std::lock_guard<std::mutex> lock(tickCallbackMutex);
+		if (tickCallbackRegistered) {
+			obs_remove_tick_callback(Tick, nullptr);
+			tickCallbackRegistered = false;
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(fadeMutex);
+	for (const auto &[_, fade] : fades) {
+		fade->SetDone();
+	}
+	fades.clear();
+}
+
+void FadeScheduler::Tick(void *, float)
+{
+	std::lock_guard<std::mutex> lock(fadeMutex);
+	if (fades.empty()) {
+		return;
+	}
+
+	const auto now = std::chrono::steady_clock::now();
+	for (auto it = fades.begin(); it != fades.end();) {
+		auto &fade = it->second;
+		if (now >= fade->_end) {
+			// Set the exact target value as the last tick will most
+			// likely not line up with the end of the fade
+			fade->_setValue(fade->_to);
+			fade->SetDone();
+			it = fades.erase(it);
+			continue;
+		}
+
+		const std::chrono::duration<double> elapsed =
+			now - fade->_start;
+		const std::chrono::duration<double> total =
+			fade->_end - fade->_start;
+		const double progress = ApplyFadeCurve(
+			fade->_curve, elapsed.count() / total.count());
+		fade->_setValue(fade->_from +
+				(fade->_to - fade->_from) * progress);
+		++it;
+	}
+}
+
+} // namespace advss
@@ -0,0 +1,74 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace advss {
+
+enum class FadeCurve {
+	LINEAR,
+	EASE_IN,
+	EASE_OUT,
+	EASE_IN_OUT,
+};
+
+double ApplyFadeCurve(FadeCurve curve, double progress);
+
+class Fade {
+public:
+	// Blocks until the fade reached its target value or was aborted
+	void Wait();
+	// Calls the callback once the fade reached its target value or was
+	// aborted, or immediately if this already happened
+	void OnDone(std::function<void()>);
+	bool Done();
+
+private:
+	void SetDone();
+
+	std::string _key;
+	const void *_owner = nullptr;
+	double _from = 0.;
+	double _to = 0.;
+	std::chrono::steady_clock::time_point _start;
+	std::chrono::steady_clock::time_point _end;
+	FadeCurve _curve = FadeCurve::LINEAR;
+	std::function<void(double)> _setValue;
+
+	std::mutex _mutex;
+	std::condition_variable _cv;
+	bool _done = false;
+	std::vector<std::function<void()>> _onDone;
+
+	friend class FadeScheduler;
+};
+
+// Advances all active fades from the OBS tick callback.
+// Fades are identified by a key, so only one fade can modify a given value at
+// any point in time, and by an owner, so all fades started by a macro can be
+// aborted once it is stopped.
+class FadeScheduler {
+public:
+	using SetValueFunc = std::function<void(double)>;
+
+	// Returns nullptr if a fade with the same key is already active and
+	// abortActive is not set.
+	// A duration of zero will set the target value immediately.
+	static std::shared_ptr<Fade>
+	Start(const std::string &key, const void *owner, double from,
+	      double to, std::chrono::milliseconds duration, FadeCurve curve,
+	      const SetValueFunc &setValue, bool abortActive);
+	static bool IsActive(const std::string &key);
+	static void Abort(const std::string &key);
+	static void AbortAll(const void *owner);
+	static void Cleanup();
+
+private:
+	static void Tick(void *, float);
+};
+
+} // namespace advss
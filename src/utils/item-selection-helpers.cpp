@@ -1,4 +1,5 @@
 #include "item-selection-helpers.hpp"
+#include "switcher-data.hpp"
 #include "utility.hpp"
 #include "name-dialog.hpp"
 
@@ -133,6 +134,7 @@ void ItemSelection::ModifyButtonClicked()
 			return;
 		}
 		if (oldName != item->_name) {
+			switcher->InvalidateSaveCache();
 			emit ItemRenamed(QString::fromStdString(oldName),
 					 QString::fromStdString(item->_name));
 		}
@@ -185,6 +187,7 @@ void ItemSelection::RenameItem()
 
 	const auto oldName = item->_name;
 	item->_name = name;
+	switcher->InvalidateSaveCache();
 	emit ItemRenamed(QString::fromStdString(oldName),
 			 QString::fromStdString(name));
 }
@@ -225,6 +228,7 @@ void ItemSelection::RemoveItem()
 		}
 	}
 
+	switcher->InvalidateSaveCache();
 	emit ItemRemoved(QString::fromStdString(name));
 }
 
@@ -0,0 +1,193 @@
+#include "key-press-queue.hpp"
+#include "platform-funcs.hpp"
+
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+namespace advss {
+
+#ifdef _WIN32
+// Windows does not repeat simulated key down events while a key is held, so
+// OBS might miss key presses which are released too quickly
+constexpr auto keyRepeatInterval = std::chrono::milliseconds(100);
+#endif
+
+namespace {
+
+struct ScheduledKeyEvent {
+	std::chrono::steady_clock::time_point time;
+	// Keeps events which are due at the same time in the order they were
+	// queued in
+	uint64_t sequence = 0;
+	bool onlySendToOBS = false;
+	std::vector<HotkeyType> keys;
+	obs_key_combination combo{};
+	bool pressed = false;
+};
+
+struct DueLater {
+	bool operator()(const ScheduledKeyEvent &a,
+			const ScheduledKeyEvent &b) const
+	{
+		if (a.time != b.time) {
+			return a.time > b.time;
+		}
+		return a.sequence > b.sequence;
+	}
+};
+
+} // namespace
+
+static std::mutex queueMutex;
+static std::condition_variable queueCV;
+static std::priority_queue<ScheduledKeyEvent, std::vector<ScheduledKeyEvent>,
+			   DueLater>
+	scheduledEvents;
+static uint64_t nextSequence = 0;
+static std::thread worker;
+static bool stopWorker = false;
+
+static void sendEvents(const std::vector<ScheduledKeyEvent> &events)
+{
+	std::vector<KeyEvent> batch;
+	for (const auto &event : events) {
+		if (event.onlySendToOBS) {
+			// Send the events collected so far first to keep the
+			// order of all events
+			if (!batch.empty()) {
+				SendKeyEvents(batch);
+				batch.clear();
+			}
+			obs_hotkey_inject_event(event.combo, event.pressed);
+			continue;
+		}
+		for (const auto key : event.keys) {
+			batch.push_back({key, event.pressed});
+		}
+	}
+	if (!batch.empty()) {
+		SendKeyEvents(batch);
+	}
+}
+
+static void workerThread()
+{
+	std::vector<ScheduledKeyEvent> dueEvents;
+	std::unique_lock<std::mutex> lock(queueMutex);
+	while (!stopWorker) {
+		if (scheduledEvents.empty()) {
+			queueCV.wait(lock, []() {
+				return stopWorker || !scheduledEvents.empty();
+			});
+			continue;
+		}
+
+		// New events might be due earlier, so check again once woken up
+		const auto nextEventTime = scheduledEvents.top().time;
+		if (std::chrono::steady_clock::now() < nextEventTime) {
+			queueCV.wait_until(lock, nextEventTime);
+			continue;
+		}
+
+		const auto now = std::chrono::steady_clock::now();
+		while (!scheduledEvents.empty() &&
+		       scheduledEvents.top().time <= now) {
+			dueEvents.push_back(scheduledEvents.top());
+			scheduledEvents.pop();
+		}
+
+		lock.unlock();
+		sendEvents(dueEvents);
+		dueEvents.clear();
+		lock.lock();
+	}
+}
+
+static void schedule(std::vector<ScheduledKeyEvent> &events)
+{
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		for (auto &event : events) {
+			event.sequence = nextSequence++;
+			scheduledEvents.push(std::move(event));
+		}
+		if (!worker.joinable()) {
+			stopWorker = false;
+			worker = std::thread(workerThread);
+		}
+	}
+	queueCV.notify_all();
+}
+
+void KeyPressQueue::Press(const std::vector<HotkeyType> &keys,
+			  std::chrono::milliseconds duration)
+{
+	ScheduledKeyEvent event;
+	event.time = std::chrono::steady_clock::now();
+	event.keys = keys;
+	event.pressed = true;
+
+	std::vector<ScheduledKeyEvent> events;
+	events.push_back(event);
+#ifdef _WIN32
+	const auto start = event.time;
+	for (auto offset = keyRepeatInterval; offset < duration;
+	     offset += keyRepeatInterval) {
+		event.time = start + offset;
+		events.push_back(event);
+	}
+	event.time = start;
+#endif
+	event.time += duration;
+	event.pressed = false;
+	events.push_back(event);
+	schedule(events);
+}
+
+void KeyPressQueue::Inject(obs_key_combination combo,
+			   std::chrono::milliseconds duration)
+{
+	ScheduledKeyEvent event;
+	event.time = std::chrono::steady_clock::now();
+	event.onlySendToOBS = true;
+	event.combo = combo;
+
+	std::vector<ScheduledKeyEvent> events;
+	// I am not sure why this is necessary
+	event.pressed = false;
+	events.push_back(event);
+	event.pressed = true;
+	events.push_back(event);
+	event.time += duration;
+	event.pressed = false;
+	events.push_back(event);
+	schedule(events);
+}
+
+void KeyPressQueue::Cleanup()
+{
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		stopWorker = true;
+	}
+	queueCV.notify_all();
+	if (worker.joinable()) {
+		worker.join();
+	}
+
+	// Make sure no key stays pressed
+	std::vector<ScheduledKeyEvent> releaseEvents;
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		for (; !scheduledEvents.empty(); scheduledEvents.pop()) {
+			if (!scheduledEvents.top().pressed) {
+				releaseEvents.push_back(scheduledEvents.top());
+			}
+		}
+	}
+	sendEvents(releaseEvents);
+}
+
+} // namespace advss
@@ -0,0 +1,28 @@
+#pragma once
+#include <obs.hpp>
+#include <chrono>
+#include <vector>
+
+namespace advss {
+
+enum class HotkeyType;
+
+// Simulates key presses on a single worker thread.
+// Each press is split into a key down and a key up event, which are scheduled
+// for the time they are due, so a long press does not block presses queued
+// after it.
+// Events are sent in the order they were queued in and all events due at the
+// same time are sent to the system as a single batch.
+class KeyPressQueue {
+public:
+	// Simulates the key presses on system level
+	static void Press(const std::vector<HotkeyType> &keys,
+			  std::chrono::milliseconds duration);
+	// Only OBS will receive the key presses
+	static void Inject(obs_key_combination combo,
+			   std::chrono::milliseconds duration);
+	// Releases all keys which are still held and stops the worker thread
+	static void Cleanup();
+};
+
+} // namespace advss
@@ -0,0 +1,98 @@
+#include "multi-pattern-matcher.hpp"
+
+namespace advss {
+
+// Limits the memory used for results of strings which are no longer checked,
+// e.g. titles of windows which were closed
+constexpr size_t maxCachedResults = 1024;
+
+// Back references and subroutine calls refer to groups by number or name,
+// which would no longer be correct once the expressions are combined
+static bool containsGroupReference(const QString &pattern)
+{
+	for (int i = 0; i + 1 < pattern.size(); i++) {
+		const auto next = pattern[i + 1];
+		const bool isGroupStart = pattern[i] == '(' && next == '?';
+		if (isGroupStart && i + 2 < pattern.size()) {
+			const auto c = pattern[i + 2];
+			if (c.isDigit() || c == '+' || c == '-' || c == 'R' ||
+			    c == '&' || c == 'P') {
+				return true;
+			}
+		}
+		if (pattern[i] != '\\') {
+			continue;
+		}
+		if (next.isDigit() || next == 'g' || next == 'k') {
+			return true;
+		}
+		// Skip the escaped character
+		i++;
+	}
+	return false;
+}
+
+void MultiPatternMatcher::SetPatterns(const std::vector<QString> &patterns)
+{
+	if (patterns == _patterns && _expressions.size() == patterns.size()) {
+		return;
+	}
+
+	_patterns = patterns;
+	_expressions.clear();
+	_cache.clear();
+	_noMatch.assign(patterns.size(), false);
+
+	QString combined;
+	bool canCombine = true;
+	for (const auto &pattern : patterns) {
+		QRegularExpression expr(
+			QRegularExpression::anchoredPattern(pattern));
+		if (expr.isValid()) {
+			if (containsGroupReference(pattern)) {
+				canCombine = false;
+			}
+			if (!combined.isEmpty()) {
+				combined += '|';
+			}
+			combined += "(?:" + pattern + ")";
+		}
+		_expressions.emplace_back(std::move(expr));
+	}
+
+	_combined = QRegularExpression();
+	if (canCombine && !combined.isEmpty()) {
+		_combined = QRegularExpression(
+			QRegularExpression::anchoredPattern(combined));
+		_combined.optimize();
+	}
+}
+
+const std::vector<bool> &MultiPatternMatcher::Match(const QString &str)
+{
+	auto key = str.toStdString();
+	auto it = _cache.find(key);
+	if (it != _cache.end()) {
+		return it->second;
+	}
+
+	if (_cache.size() >= maxCachedResults) {
+		_cache.clear();
+	}
+
+	// An invalid combined expression, e.g. caused by duplicate group
+	// names, only means that all expressions have to be checked
+	if (_combined.isValid() && !_combined.pattern().isEmpty() &&
+	    !_combined.match(str).hasMatch()) {
+		return _cache.emplace(std::move(key), _noMatch).first->second;
+	}
+
+	std::vector<bool> result(_expressions.size(), false);
+	for (size_t i = 0; i < _expressions.size(); i++) {
+		result[i] = _expressions[i].isValid() &&
+			    _expressions[i].match(str).hasMatch();
+	}
+	return _cache.emplace(std::move(key), std::move(result)).first->second;
+}
+
+} // namespace advss
@@ -0,0 +1,34 @@
+#pragma once
+#include <QRegularExpression>
+#include <QString>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace advss {
+
+// Checks a string against a set of regular expressions at once and reports
+// which of them match the whole string.
+// The expressions are only compiled again once the patterns change and the
+// results of recently checked strings are cached, as mostly the same window
+// titles and process names are checked every interval.
+class MultiPatternMatcher {
+public:
+	// Recompiles the expressions only if the patterns differ from the
+	// ones which were set before
+	void SetPatterns(const std::vector<QString> &patterns);
+	bool IsValid(size_t idx) const { return _expressions[idx].isValid(); }
+	// Element i is true if pattern i matches the whole string.
+	// The returned reference is only valid until the next call.
+	const std::vector<bool> &Match(const QString &str);
+
+private:
+	std::vector<QString> _patterns;
+	std::vector<QRegularExpression> _expressions;
+	// Quickly rejects strings which are not matched by any pattern
+	QRegularExpression _combined;
+	std::vector<bool> _noMatch;
+	std::unordered_map<std::string, std::vector<bool>> _cache;
+};
+
+} // namespace advss
@@ -22,68 +22,59 @@ std::unordered_map<size_t, OSCMessageElement::TypeInfo>
 };
 
 // Based on https://github.com/mhroth/tinyosc
-struct FillMessageElementBufferVisitor {
-	std::vector<char> &buffer;
-	uint32_t &curOffset;
+// Strings are null terminated and all elements are padded to a multiple of
+// four bytes
+static void appendPadded(std::vector<char> &buffer, const char *data,
+			 size_t length, bool nullTerminate)
+{
+	buffer.insert(buffer.end(), data, data + length);
+	const size_t size = buffer.size() + (nullTerminate ? 1 : 0);
+	buffer.resize((size + 3) & ~static_cast<size_t>(0x3), '\0');
+}
 
-	bool success = false;
+static void appendInt32(std::vector<char> &buffer, uint32_t value)
+{
+	const uint32_t networkValue = htonl(value);
+	const char *data = reinterpret_cast<const char *>(&networkValue);
+	buffer.insert(buffer.end(), data, data + sizeof(networkValue));
+}
+
+struct AppendMessageElementVisitor {
+	std::vector<char> &buffer;
 
-	void operator()(const StringVariable &value)
+	bool operator()(const StringVariable &value)
 	{
-		std::string string = value;
-		int length = (int)strlen(string.c_str());
-		if (curOffset + length >= buffer.size()) {
-			buffer.resize(curOffset + length + 1);
-		}
-		strncpy(buffer.data() + curOffset, string.c_str(),
-			buffer.size() - curOffset - length);
-		curOffset = (curOffset + 4 + length) & ~0x3;
-		success = true;
+		const char *string = value.c_str();
+		appendPadded(buffer, string, strlen(string), true);
+		return true;
 	}
-	void operator()(const IntVariable &value)
+	bool operator()(const IntVariable &value)
 	{
-		if (curOffset + 4 > buffer.size()) {
-			buffer.resize(curOffset + 4);
-		}
-		int32_t k = value;
-		*((uint32_t *)(buffer.data() + curOffset)) = htonl(k);
-		curOffset += 4;
-		success = true;
+		appendInt32(buffer, static_cast<uint32_t>(value.GetValue()));
+		return true;
 	}
-	void operator()(const DoubleVariable &value)
+	bool operator()(const DoubleVariable &value)
 	{
-		if (curOffset + 4 > buffer.size()) {
-			buffer.resize(curOffset + 4);
-		}
 		const float f = value;
-		*((uint32_t *)(buffer.data() + curOffset)) =
-			htonl(*((uint32_t *)&f));
-		curOffset += 4;
-		success = true;
+		uint32_t bits;
+		memcpy(&bits, &f, sizeof(bits));
+		appendInt32(buffer, bits);
+		return true;
 	}
-	void operator()(const OSCBlob &value)
+	bool operator()(const OSCBlob &value)
 	{
-		if (curOffset + 4 > buffer.size()) {
-			buffer.resize(curOffset + 4);
-		}
 		auto blob = value.GetBinary();
 		if (!blob.has_value()) {
-			return;
+			return false;
 		}
-		if (curOffset + 4 + blob->size() > buffer.size()) {
-			buffer.resize(curOffset + 4 + blob->size());
-		}
-		*((uint32_t *)(buffer.data() + curOffset)) =
-			htonl(blob->size());
-		curOffset += 4;
-		memcpy(buffer.data() + curOffset, blob->data(), blob->size());
-		curOffset = (curOffset + 3 + blob->size()) & ~0x3;
-		success = true;
+		appendInt32(buffer, static_cast<uint32_t>(blob->size()));
+		appendPadded(buffer, blob->data(), blob->size(), false);
+		return true;
 	}
-	void operator()(const OSCTrue &) { success = true; }
-	void operator()(const OSCFalse &) { success = true; }
-	void operator()(const OSCInfinity &) { success = true; }
-	void operator()(const OSCNull &) { success = true; }
+	bool operator()(const OSCTrue &) { return true; }
+	bool operator()(const OSCFalse &) { return true; }
+	bool operator()(const OSCInfinity &) { return true; }
+	bool operator()(const OSCNull &) { return true; }
 };
 
 OSCBlob::OSCBlob(const std::string &stringRepresentation)
@@ -152,47 +143,52 @@ void OSCNull::Save(obs_data_t *obj, const char *name) const
 	obs_data_set_bool(obj, name, true);
 }
 
-std::optional<std::vector<char>> OSCMessage::GetBuffer() const
+bool OSCMessage::Encode(std::vector<char> &buffer) const
 {
-	if (std::string(_address).empty()) {
-		return {};
+	const char *address = _address.c_str();
+	if (*address == '\0') {
+		return false;
 	}
 
-	std::vector<char> buffer(128, 0);
-	uint32_t currentOffset = (uint32_t)strlen(_address.c_str());
-	if (currentOffset > buffer.size()) {
-		buffer.resize(buffer.size() * 2);
-	}
-	strncpy(buffer.data(), _address.c_str(), buffer.size());
-	currentOffset = (currentOffset + 4) & ~0x3;
+	buffer.clear();
+	appendPadded(buffer, address, strlen(address), true);
 
-	std::string typeTags;
+	buffer.push_back(',');
 	for (const auto &e : _elements) {
-		typeTags += e.GetTypeTag();
-	}
-
-	buffer.at(currentOffset++) = ',';
-	int length = (int)strlen(typeTags.c_str());
-	if (currentOffset + length >= buffer.size()) {
-		buffer.resize(buffer.size() * 2);
+		buffer.push_back(*e.GetTypeTag());
 	}
-	strncpy(buffer.data() + currentOffset, typeTags.c_str(),
-		buffer.size() - currentOffset - length);
-	currentOffset = (currentOffset + 4 + length) & ~0x3;
+	buffer.push_back('\0');
+	buffer.resize((buffer.size() + 3) & ~static_cast<size_t>(0x3), '\0');
 
+	AppendMessageElementVisitor visitor{buffer};
 	for (const auto &e : _elements) {
-		const auto &value = e._value;
-		FillMessageElementBufferVisitor visitor{buffer, currentOffset};
-		std::visit(visitor, value);
-		if (!visitor.success) {
-			return {};
+		if (!std::visit(visitor, e._value)) {
+			return false;
 		}
 	}
+	return true;
+}
 
-	buffer.resize(currentOffset);
+std::optional<std::vector<char>> OSCMessage::GetBuffer() const
+{
+	std::vector<char> buffer;
+	if (!Encode(buffer)) {
+		return {};
+	}
 	return buffer;
 }
 
+const std::vector<char> *OSCMessage::GetCachedBuffer() const
+{
+	const auto lastVariableChange = GetLastVariableChangeTime();
+	if (!_cache.valid || _cache.lastVariableChange != lastVariableChange) {
+		_cache.success = Encode(_cache.buffer);
+		_cache.lastVariableChange = lastVariableChange;
+		_cache.valid = true;
+	}
+	return _cache.success ? &_cache.buffer : nullptr;
+}
+
 const char *OSCMessageElement::GetTypeTag() const
 {
 	return GetTypeTag(*this);
@@ -315,6 +311,7 @@ void OSCMessage::Load(obs_data_t *obj)
 {
 
 	auto data = obs_data_get_obj(obj, "oscMessage");
+	_cache.valid = false;
 	_address.Load(data, "address");
 	_elements.clear();
 	auto elements = obs_data_get_array(data, "elements");
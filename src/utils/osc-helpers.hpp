@@ -90,13 +90,38 @@ public:
 
 	std::string ToString() const;
 	std::optional<std::vector<char>> GetBuffer() const;
+	// Only encodes the message again if it or any variable was modified
+	// since the last call.
+	// Returns nullptr if the message could not be encoded.
+	const std::vector<char> *GetCachedBuffer() const;
 
 private:
+	bool Encode(std::vector<char> &buffer) const;
+
 	StringVariable _address = "/address";
 	std::vector<OSCMessageElement> _elements = {
 		OSCMessageElement("example"),
 		OSCMessageElement(IntVariable(3))};
 
+	// Copies start out invalidated, as the OSCMessageEdit modifies its
+	// copy of the message directly
+	struct EncodingCache {
+		EncodingCache() = default;
+		EncodingCache(const EncodingCache &) {}
+		EncodingCache &operator=(const EncodingCache &)
+		{
+			valid = false;
+			return *this;
+		}
+
+		bool valid = false;
+		bool success = false;
+		std::chrono::high_resolution_clock::time_point
+			lastVariableChange{};
+		std::vector<char> buffer;
+	};
+	mutable EncodingCache _cache;
+
 	friend class OSCMessageEdit;
 };
 
@@ -0,0 +1,241 @@
+#include "osc-transport.hpp"
+#include "log-helper.hpp"
+#include "timer-wheel.hpp"
+
+#include <unordered_map>
+
+namespace advss {
+
+// Synchronous operations do not require the context to be run, so a single
+// context is sufficient for all sockets
+static asio::io_context ioContext;
+static std::mutex transportMutex;
+static std::unordered_map<std::string, std::weak_ptr<OSCTransport>>
+	transports;
+
+constexpr auto reconnectInterval = std::chrono::seconds(1);
+// Bundles are sent once no further message was added for this long, so
+// messages of consecutive actions still end up in the same bundle
+constexpr auto bundleFlushDelay = std::chrono::milliseconds(50);
+static TimerWheel bundleFlushTimers;
+// Largest payload of a single UDP datagram
+constexpr size_t maxBundleSize = 65507;
+// "#bundle" followed by the time tag 1, which means "immediately"
+constexpr char bundleHeader[] = {'#', 'b', 'u', 'n', 'd', 'l', 'e', '\0',
+				 0,   0,   0,   0,   0,   0,   0,   1};
+
+static std::string getKey(OSCTransport::Protocol protocol,
+			  const std::string &host, int port)
+{
+	const char *prefix = protocol == OSCTransport::Protocol::TCP ? "tcp:"
+								     : "udp:";
+	return prefix + host + ":" + std::to_string(port);
+}
+
+OSCTransport::OSCTransport(Protocol protocol, const std::string &host,
+			   int port)
+	: _protocol(protocol),
+	  _host(host),
+	  _port(port),
+	  _key(getKey(protocol, host, port)),
+	  _tcpSocket(ioContext),
+	  _udpSocket(ioContext)
+{
+	StartBundle();
+}
+
+OSCTransport::~OSCTransport()
+{
+	if (_bundledMessageCount > 0) {
+		Write(_bundle);
+	}
+
+	std::lock_guard<std::mutex> lock(transportMutex);
+	auto it = transports.find(_key);
+	if (it != transports.end() && it->second.expired()) {
+		transports.erase(it);
+	}
+}
+
+std::shared_ptr<OSCTransport> OSCTransport::Get(Protocol protocol,
+						const std::string &host,
+						int port)
+{
+	std::lock_guard<std::mutex> lock(transportMutex);
+	auto &entry = transports[getKey(protocol, host, port)];
+	auto transport = entry.lock();
+	if (!transport) {
+		transport = std::shared_ptr<OSCTransport>(
+			new OSCTransport(protocol, host, port));
+		entry = transport;
+	}
+	return transport;
+}
+
+bool OSCTransport::Matches(Protocol protocol, const char *host, int port) const
+{
+	return _protocol == protocol && _port == port && _host == host;
+}
+
+const char *OSCTransport::GetProtocolName() const
+{
+	return _protocol == Protocol::TCP ? "TCP" : "UDP";
+}
+
+bool OSCTransport::Connect()
+{
+	// Avoid resolving the host for every single message if the server is
+	// not reachable
+	const auto now = std::chrono::steady_clock::now();
+	if (now - _lastConnectAttempt < reconnectInterval) {
+		return false;
+	}
+	_lastConnectAttempt = now;
+
+	const auto port = std::to_string(_port);
+	asio::error_code ec;
+	try {
+		if (_protocol == Protocol::TCP) {
+			asio::ip::tcp::resolver resolver(ioContext);
+			auto endpoints = resolver.resolve(asio::ip::tcp::v4(),
+							  _host, port, ec);
+			if (ec) {
+				endpoints = resolver.resolve(
+					asio::ip::tcp::v6(), _host, port, ec);
+			}
+			if (ec) {
+				blog(LOG_WARNING,
+				     "failed to get IP for \"%s\": %s",
+				     _host.c_str(), ec.message().c_str());
+				return false;
+			}
+			_tcpSocket = asio::ip::tcp::socket(ioContext);
+			_tcpSocket.connect(endpoints.begin()->endpoint());
+		} else {
+			asio::ip::udp::resolver resolver(ioContext);
+			auto endpoints = resolver.resolve(asio::ip::udp::v4(),
+							  _host, port, ec);
+			if (ec) {
+				endpoints = resolver.resolve(
+					asio::ip::udp::v6(), _host, port, ec);
+			}
+			if (ec) {
+				blog(LOG_WARNING,
+				     "failed to get IP for \"%s\": %s",
+				     _host.c_str(), ec.message().c_str());
+				return false;
+			}
+			_udpEndpoint = endpoints.begin()->endpoint();
+			_udpSocket = asio::ip::udp::socket(ioContext);
+			_udpSocket.open(_udpEndpoint.protocol());
+		}
+	} catch (const std::exception &e) {
+		blog(LOG_WARNING, "failed to connect to %s %s %d: %s",
+		     GetProtocolName(), _host.c_str(), _port, e.what());
+		return false;
+	}
+
+	_connected = true;
+	return true;
+}
+
+bool OSCTransport::Write(const std::vector<char> &packet)
+{
+	if (!_connected && !Connect()) {
+		return false;
+	}
+
+	try {
+		if (_protocol == Protocol::TCP) {
+			asio::write(_tcpSocket, asio::buffer(packet));
+		} else {
+			_udpSocket.send_to(asio::buffer(packet), _udpEndpoint);
+		}
+	} catch (const std::exception &e) {
+		blog(LOG_WARNING, "failed to send OSC packet via %s %s %d: %s",
+		     GetProtocolName(), _host.c_str(), _port, e.what());
+		// Force a reconnect on the next attempt
+		_connected = false;
+		return false;
+	}
+	return true;
+}
+
+void OSCTransport::StartBundle()
+{
+	_bundle.assign(std::begin(bundleHeader), std::end(bundleHeader));
+	_bundledMessageCount = 0;
+}
+
+void OSCTransport::AppendToBundle(const std::vector<char> &message)
+{
+	// Each bundle element is prefixed with its size as a big endian int32
+	const uint32_t size = static_cast<uint32_t>(message.size());
+	const char sizeBytes[] = {static_cast<char>((size >> 24) & 0xFF),
+				  static_cast<char>((size >> 16) & 0xFF),
+				  static_cast<char>((size >> 8) & 0xFF),
+				  static_cast<char>(size & 0xFF)};
+	_bundle.insert(_bundle.end(), std::begin(sizeBytes),
+		       std::end(sizeBytes));
+	_bundle.insert(_bundle.end(), message.begin(), message.end());
+	++_bundledMessageCount;
+}
+
+void OSCTransport::Send(const std::vector<char> &message)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (_bundledMessageCount == 0) {
+		Write(message);
+		return;
+	}
+
+	AppendToBundle(message);
+	Write(_bundle);
+	StartBundle();
+}
+
+void OSCTransport::AddToBundle(const std::vector<char> &message)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (_bundledMessageCount > 0 &&
+	    _bundle.size() + 4 + message.size() > maxBundleSize) {
+		Write(_bundle);
+		StartBundle();
+	}
+	AppendToBundle(message);
+	_lastBundledMessageTime = std::chrono::steady_clock::now();
+	if (!_bundleFlushScheduled) {
+		_bundleFlushScheduled = true;
+		ScheduleBundleFlush(_lastBundledMessageTime + bundleFlushDelay);
+	}
+}
+
+void OSCTransport::ScheduleBundleFlush(
+	std::chrono::steady_clock::time_point time)
+{
+	std::weak_ptr<OSCTransport> weakTransport = shared_from_this();
+	bundleFlushTimers.Schedule(time, [weakTransport]() {
+		if (auto transport = weakTransport.lock()) {
+			transport->FlushBundle();
+		}
+	});
+}
+
+void OSCTransport::FlushBundle()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (_bundledMessageCount == 0) {
+		_bundleFlushScheduled = false;
+		return;
+	}
+	const auto flushTime = _lastBundledMessageTime + bundleFlushDelay;
+	if (std::chrono::steady_clock::now() < flushTime) {
+		ScheduleBundleFlush(flushTime);
+		return;
+	}
+	Write(_bundle);
+	StartBundle();
+	_bundleFlushScheduled = false;
+}
+
+} // namespace advss
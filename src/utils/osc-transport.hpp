@@ -0,0 +1,59 @@
+#pragma once
+#include <asio.hpp>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace advss {
+
+// Connection to an OSC server shared by everything sending to the same
+// protocol, host and port combination.
+// Messages can be collected in a bundle, which is sent as a single packet
+// together with the next message to this destination which is not bundled,
+// or once no further message was added to it for a short time.
+class OSCTransport : public std::enable_shared_from_this<OSCTransport> {
+public:
+	enum class Protocol {
+		TCP,
+		UDP,
+	};
+
+	~OSCTransport();
+	static std::shared_ptr<OSCTransport>
+	Get(Protocol protocol, const std::string &host, int port);
+
+	bool Matches(Protocol protocol, const char *host, int port) const;
+	void Send(const std::vector<char> &message);
+	void AddToBundle(const std::vector<char> &message);
+
+private:
+	OSCTransport(Protocol protocol, const std::string &host, int port);
+	bool Connect();
+	bool Write(const std::vector<char> &packet);
+	void StartBundle();
+	void AppendToBundle(const std::vector<char> &message);
+	void ScheduleBundleFlush(std::chrono::steady_clock::time_point);
+	void FlushBundle();
+	const char *GetProtocolName() const;
+
+	const Protocol _protocol;
+	const std::string _host;
+	const int _port;
+	const std::string _key;
+
+	std::mutex _mutex;
+	asio::ip::tcp::socket _tcpSocket;
+	asio::ip::udp::socket _udpSocket;
+	asio::ip::udp::endpoint _udpEndpoint;
+	bool _connected = false;
+	std::chrono::steady_clock::time_point _lastConnectAttempt{};
+
+	std::vector<char> _bundle;
+	size_t _bundledMessageCount = 0;
+	std::chrono::steady_clock::time_point _lastBundledMessageTime{};
+	bool _bundleFlushScheduled = false;
+};
+
+} // namespace advss
@@ -38,17 +38,45 @@ void RegexConfig::CreateBackwardsCompatibleRegex(bool enable, bool setOptions)
 
 QRegularExpression RegexConfig::GetRegularExpression(const QString &expr) const
 {
-	if (_partialMatch) {
-		return QRegularExpression(expr, _options);
-	}
-	return QRegularExpression(QRegularExpression::anchoredPattern(expr),
-				  _options);
+	std::lock_guard<std::mutex> lock(_cache.mutex);
+	return CompileExpression(expr);
 }
 
 QRegularExpression
 RegexConfig::GetRegularExpression(const std::string &expr) const
 {
-	return GetRegularExpression(QString::fromStdString(expr));
+	std::lock_guard<std::mutex> lock(_cache.mutex);
+	// Avoid the conversion to QString if the expression did not change
+	if (_cache.valid && !_cache.stdPattern.empty() &&
+	    _cache.stdPattern == expr && _cache.partialMatch == _partialMatch &&
+	    _cache.expression.patternOptions() == _options) {
+		return _cache.expression;
+	}
+	auto regex = CompileExpression(QString::fromStdString(expr));
+	_cache.stdPattern = expr;
+	return regex;
+}
+
+// Has to be called while holding the cache mutex
+QRegularExpression RegexConfig::CompileExpression(const QString &expr) const
+{
+	if (_cache.valid && _cache.partialMatch == _partialMatch &&
+	    _cache.expression.patternOptions() == _options &&
+	    _cache.pattern == expr) {
+		return _cache.expression;
+	}
+
+	_cache.valid = true;
+	_cache.pattern = expr;
+	_cache.stdPattern.clear();
+	_cache.partialMatch = _partialMatch;
+	if (_partialMatch) {
+		_cache.expression = QRegularExpression(expr, _options);
+	} else {
+		_cache.expression = QRegularExpression(
+			QRegularExpression::anchoredPattern(expr), _options);
+	}
+	return _cache.expression;
 }
 
 RegexConfig RegexConfig::PartialMatchRegexConfig()
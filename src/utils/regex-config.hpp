@@ -7,6 +7,8 @@
 #include <QDialog>
 #include <QDialogButtonBox>
 #include <QRegularExpression>
+#include <mutex>
+#include <string>
 
 namespace advss {
 
@@ -37,6 +39,32 @@ private:
 	bool _partialMatch = false;
 	QRegularExpression::PatternOptions _options =
 		QRegularExpression::NoPatternOption;
+
+	QRegularExpression CompileExpression(const QString &) const;
+
+	// Conditions usually check the same expression every interval, so
+	// keep the last compiled expression around to avoid creating and
+	// compiling it again.
+	// The UI and the switcher thread might use the same config at the same
+	// time, so the cache is guarded by its own mutex.
+	struct ExpressionCache {
+		ExpressionCache() = default;
+		// Copies start with an empty cache
+		ExpressionCache(const ExpressionCache &) {}
+		ExpressionCache &operator=(const ExpressionCache &)
+		{
+			return *this;
+		}
+
+		std::mutex mutex;
+		bool valid = false;
+		QString pattern;
+		std::string stdPattern;
+		bool partialMatch = false;
+		QRegularExpression expression;
+	};
+	mutable ExpressionCache _cache;
+
 	friend RegexConfigWidget;
 	friend RegexConfigDialog;
 };
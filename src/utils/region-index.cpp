@@ -0,0 +1,131 @@
+#include "region-index.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace advss {
+
+// Limits the memory used by setups with lots of regions
+constexpr size_t maxGridSize = 64;
+
+static bool isEmpty(const RegionIndex::Region &region)
+{
+	return region.minX > region.maxX || region.minY > region.maxY;
+}
+
+void RegionIndex::Build(const std::vector<Region> &regions)
+{
+	_regions = regions;
+	_columns = 0;
+	_rows = 0;
+	_cellStart.clear();
+	_cellEntries.clear();
+
+	bool found = false;
+	long long minX = 0, minY = 0, maxX = 0, maxY = 0;
+	for (const auto &region : _regions) {
+		if (isEmpty(region)) {
+			continue;
+		}
+		if (!found) {
+			minX = region.minX;
+			minY = region.minY;
+			maxX = region.maxX;
+			maxY = region.maxY;
+			found = true;
+			continue;
+		}
+		minX = std::min<long long>(minX, region.minX);
+		minY = std::min<long long>(minY, region.minY);
+		maxX = std::max<long long>(maxX, region.maxX);
+		maxY = std::max<long long>(maxY, region.maxY);
+	}
+	if (!found) {
+		return;
+	}
+
+	// Aim for about one region per cell
+	const size_t gridSize = std::clamp<size_t>(
+		static_cast<size_t>(std::ceil(std::sqrt(_regions.size()))), 1,
+		maxGridSize);
+	_originX = minX;
+	_originY = minY;
+	_columns = gridSize;
+	_rows = gridSize;
+	_cellWidth = (maxX - minX + gridSize) / gridSize;
+	_cellHeight = (maxY - minY + gridSize) / gridSize;
+
+	// Count the regions of each cell first, so all entries can be stored
+	// in a single vector
+	_cellStart.assign(_columns * _rows + 1, 0);
+	auto forEachCell = [this](const Region &region, auto &&func) {
+		const size_t firstCol = (region.minX - _originX) / _cellWidth;
+		const size_t lastCol = (region.maxX - _originX) / _cellWidth;
+		const size_t firstRow = (region.minY - _originY) / _cellHeight;
+		const size_t lastRow = (region.maxY - _originY) / _cellHeight;
+		for (size_t row = firstRow; row <= lastRow; row++) {
+			for (size_t col = firstCol; col <= lastCol; col++) {
+				func(row * _columns + col);
+			}
+		}
+	};
+	for (const auto &region : _regions) {
+		if (isEmpty(region)) {
+			continue;
+		}
+		forEachCell(region,
+			    [this](size_t cell) { ++_cellStart[cell]; });
+	}
+	size_t offset = 0;
+	for (auto &start : _cellStart) {
+		const size_t count = start;
+		start = offset;
+		offset += count;
+	}
+
+	// Regions are added in ascending order, so the entries of each cell
+	// are sorted as well
+	_cellEntries.resize(offset);
+	std::vector<size_t> next(_cellStart.begin(), _cellStart.end() - 1);
+	for (size_t i = 0; i < _regions.size(); i++) {
+		if (isEmpty(_regions[i])) {
+			continue;
+		}
+		forEachCell(_regions[i], [this, &next, i](size_t cell) {
+			_cellEntries[next[cell]++] = i;
+		});
+	}
+}
+
+bool RegionIndex::GetCell(int x, int y, size_t &cell) const
+{
+	if (_columns == 0 || x < _originX || y < _originY) {
+		return false;
+	}
+	const size_t column = (x - _originX) / _cellWidth;
+	const size_t row = (y - _originY) / _cellHeight;
+	if (column >= _columns || row >= _rows) {
+		return false;
+	}
+	cell = row * _columns + column;
+	return true;
+}
+
+void RegionIndex::Query(int x, int y, std::vector<size_t> &result) const
+{
+	result.clear();
+	size_t cell;
+	if (!GetCell(x, y, cell)) {
+		return;
+	}
+	for (size_t i = _cellStart[cell]; i < _cellStart[cell + 1]; i++) {
+		const auto idx = _cellEntries[i];
+		const auto &region = _regions[idx];
+		if (x >= region.minX && y >= region.minY && x <= region.maxX &&
+		    y <= region.maxY) {
+			result.push_back(idx);
+		}
+	}
+}
+
+} // namespace advss
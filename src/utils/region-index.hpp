@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+namespace advss {
+
+// Finds all regions containing a given point without checking each of them.
+// The regions are sorted into a uniform grid once, so a lookup only has to
+// check the regions overlapping the grid cell containing the point.
+class RegionIndex {
+public:
+	// Bounds are inclusive
+	struct Region {
+		int minX = 0;
+		int minY = 0;
+		int maxX = 0;
+		int maxY = 0;
+	};
+
+	void Build(const std::vector<Region> &regions);
+	// Returns the indices of all regions containing the point in ascending
+	// order
+	void Query(int x, int y, std::vector<size_t> &result) const;
+
+private:
+	bool GetCell(int x, int y, size_t &cell) const;
+
+	std::vector<Region> _regions;
+	long long _originX = 0;
+	long long _originY = 0;
+	long long _cellWidth = 1;
+	long long _cellHeight = 1;
+	size_t _columns = 0;
+	size_t _rows = 0;
+	// The regions of cell i are stored at
+	// _cellEntries[_cellStart[i]] to _cellEntries[_cellStart[i + 1] - 1]
+	std::vector<size_t> _cellStart;
+	std::vector<size_t> _cellEntries;
+};
+
+} // namespace advss
@@ -43,14 +43,21 @@ Section::Section(const int animationDuration, QWidget *parent)
 
 void Section::Collapse(bool collapse)
 {
+	// Content which was not created yet is only needed once it is shown
+	if (!collapse) {
+		CreateContent();
+	}
 	_toggleButton->setChecked(collapse);
 	_toggleButton->setArrowType(collapse ? Qt::ArrowType::RightArrow
 					     : Qt::ArrowType::DownArrow);
-	_toggleAnimation->setDirection(collapse ? QAbstractAnimation::Backward
-						: QAbstractAnimation::Forward);
-	_transitioning = true;
 	_collapsed = collapse;
-	_toggleAnimation->start();
+	if (_toggleAnimation) {
+		_toggleAnimation->setDirection(
+			collapse ? QAbstractAnimation::Backward
+				 : QAbstractAnimation::Forward);
+		_transitioning = true;
+		_toggleAnimation->start();
+	}
 	emit Collapsed(collapse);
 }
 
@@ -61,6 +68,7 @@ void Section::SetContent(QWidget *w)
 
 void Section::SetContent(QWidget *w, bool collapsed)
 {
+	_createContent = nullptr;
 	CleanUpPreviousContent();
 	delete _contentArea;
 
@@ -100,6 +108,36 @@ void Section::SetContent(QWidget *w, bool collapsed)
 	_collapsed = collapsed;
 }
 
+void Section::SetContent(const std::function<QWidget *()> &createContent,
+			 bool collapsed)
+{
+	CleanUpPreviousContent();
+	delete _contentArea;
+	_contentArea = nullptr;
+	_content = nullptr;
+	delete _toggleAnimation;
+	_toggleAnimation = nullptr;
+	_createContent = createContent;
+
+	setMinimumHeight(0);
+	setMaximumHeight(QWIDGETSIZE_MAX);
+	const QSignalBlocker b(_toggleButton);
+	_toggleButton->setChecked(collapsed);
+	_toggleButton->setArrowType(collapsed ? Qt::ArrowType::RightArrow
+					      : Qt::ArrowType::DownArrow);
+	_collapsed = collapsed;
+}
+
+void Section::CreateContent()
+{
+	if (!_createContent) {
+		return;
+	}
+	auto createContent = std::move(_createContent);
+	_createContent = nullptr;
+	SetContent(createContent(), _collapsed);
+}
+
 void Section::AddHeaderWidget(QWidget *w)
 {
 	_headerWidgetLayout->addWidget(w);
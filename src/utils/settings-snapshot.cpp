@@ -0,0 +1,411 @@
+#include "settings-snapshot.hpp"
+#include "log-helper.hpp"
+
+#include <cstring>
+#include <QFile>
+
+namespace advss {
+
+constexpr char snapshotMagic[] = {'A', 'D', 'V', 'S', 'S', 'N', 'A', 'P'};
+constexpr uint32_t snapshotVersion = 1;
+constexpr size_t headerSize = sizeof(snapshotMagic) + sizeof(uint32_t);
+// Protect against running out of stack space with malformed snapshots
+constexpr int maxNestingDepth = 128;
+
+enum class ValueType : uint8_t {
+	STRING = 1,
+	INT,
+	DOUBLE,
+	BOOL_FALSE,
+	BOOL_TRUE,
+	OBJECT,
+	ARRAY,
+};
+
+static void writeVarint(QByteArray &out, uint64_t value)
+{
+	while (value >= 0x80) {
+		out.append(static_cast<char>((value & 0x7F) | 0x80));
+		value >>= 7;
+	}
+	out.append(static_cast<char>(value));
+}
+
+static void writeString(QByteArray &out, const char *str)
+{
+	const size_t len = str ? strlen(str) : 0;
+	writeVarint(out, len);
+	out.append(str, static_cast<int>(len));
+}
+
+static void writeUint32(QByteArray &out, uint32_t value)
+{
+	for (int i = 0; i < 4; i++) {
+		out.append(static_cast<char>((value >> (8 * i)) & 0xFF));
+	}
+}
+
+static void writeDouble(QByteArray &out, double value)
+{
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	for (int i = 0; i < 8; i++) {
+		out.append(static_cast<char>((bits >> (8 * i)) & 0xFF));
+	}
+}
+
+static void encodeObject(QByteArray &out, obs_data_t *obj);
+
+static void encodeArray(QByteArray &out, obs_data_array_t *array)
+{
+	const size_t count = obs_data_array_count(array);
+	writeVarint(out, count);
+	for (size_t i = 0; i < count; i++) {
+		obs_data_t *item = obs_data_array_item(array, i);
+		encodeObject(out, item);
+		obs_data_release(item);
+	}
+}
+
+static bool encodeItem(QByteArray &out, obs_data_item_t *item)
+{
+	switch (obs_data_item_gettype(item)) {
+	case OBS_DATA_STRING:
+		out.append(static_cast<char>(ValueType::STRING));
+		writeString(out, obs_data_item_get_string(item));
+		return true;
+	case OBS_DATA_NUMBER:
+		if (obs_data_item_numtype(item) == OBS_DATA_NUM_INT) {
+			out.append(static_cast<char>(ValueType::INT));
+			// Zigzag encoding to keep small negative values short
+			const int64_t value = obs_data_item_get_int(item);
+			const uint64_t zigzag =
+				(static_cast<uint64_t>(value) << 1) ^
+				static_cast<uint64_t>(value >> 63);
+			writeVarint(out, zigzag);
+		} else {
+			out.append(static_cast<char>(ValueType::DOUBLE));
+			writeDouble(out, obs_data_item_get_double(item));
+		}
+		return true;
+	case OBS_DATA_BOOLEAN:
+		out.append(static_cast<char>(obs_data_item_get_bool(item)
+						     ? ValueType::BOOL_TRUE
+						     : ValueType::BOOL_FALSE));
+		return true;
+	case OBS_DATA_OBJECT: {
+		out.append(static_cast<char>(ValueType::OBJECT));
+		obs_data_t *obj = obs_data_item_get_obj(item);
+		encodeObject(out, obj);
+		obs_data_release(obj);
+		return true;
+	}
+	case OBS_DATA_ARRAY: {
+		out.append(static_cast<char>(ValueType::ARRAY));
+		obs_data_array_t *array = obs_data_item_get_array(item);
+		encodeArray(out, array);
+		obs_data_array_release(array);
+		return true;
+	}
+	default:
+		break;
+	}
+	return false;
+}
+
+static void encodeObject(QByteArray &out, obs_data_t *obj)
+{
+	// The number of items is only known after skipping the ones without
+	// a user value, so encode them into a separate buffer first
+	QByteArray items;
+	uint64_t count = 0;
+	for (obs_data_item_t *item = obs_data_first(obj); item;
+	     obs_data_item_next(&item)) {
+		if (!obs_data_item_has_user_value(item)) {
+			continue;
+		}
+		const int sizeBefore = items.size();
+		writeString(items, obs_data_item_get_name(item));
+		if (!encodeItem(items, item)) {
+			items.truncate(sizeBefore);
+			continue;
+		}
+		++count;
+	}
+	writeVarint(out, count);
+	out.append(items);
+}
+
+QByteArray EncodeSettingsSnapshot(obs_data_t *obj)
+{
+	QByteArray out(snapshotMagic, sizeof(snapshotMagic));
+	writeUint32(out, snapshotVersion);
+	encodeObject(out, obj);
+	return out;
+}
+
+namespace {
+
+class SnapshotReader {
+public:
+	SnapshotReader(const char *data, size_t size)
+		: _pos(data),
+		  _end(data + size)
+	{
+	}
+	bool ReadObject(obs_data_t *obj, int depth);
+	bool AtEnd() const { return _pos == _end; }
+
+private:
+	bool ReadByte(uint8_t &value);
+	bool ReadVarint(uint64_t &value);
+	bool ReadString(std::string &value);
+	bool ReadDouble(double &value);
+	bool ReadArray(obs_data_array_t *array, int depth);
+	bool ReadItem(obs_data_t *obj, const char *name, int depth);
+
+	const char *_pos;
+	const char *const _end;
+};
+
+} // namespace
+
+bool SnapshotReader::ReadByte(uint8_t &value)
+{
+	if (_pos >= _end) {
+		return false;
+	}
+	value = static_cast<uint8_t>(*_pos++);
+	return true;
+}
+
+bool SnapshotReader::ReadVarint(uint64_t &value)
+{
+	value = 0;
+	for (int shift = 0; shift < 64; shift += 7) {
+		uint8_t byte;
+		if (!ReadByte(byte)) {
+			return false;
+		}
+		value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+		if (!(byte & 0x80)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool SnapshotReader::ReadString(std::string &value)
+{
+	uint64_t len;
+	if (!ReadVarint(len) || len > static_cast<uint64_t>(_end - _pos)) {
+		return false;
+	}
+	value.assign(_pos, static_cast<size_t>(len));
+	_pos += len;
+	return true;
+}
+
+bool SnapshotReader::ReadDouble(double &value)
+{
+	if (_end - _pos < 8) {
+		return false;
+	}
+	uint64_t bits = 0;
+	for (int i = 0; i < 8; i++) {
+		bits |= static_cast<uint64_t>(static_cast<uint8_t>(_pos[i]))
+			<< (8 * i);
+	}
+	_pos += 8;
+	memcpy(&value, &bits, sizeof(value));
+	return true;
+}
+
+bool SnapshotReader::ReadArray(obs_data_array_t *array, int depth)
+{
+	uint64_t count;
+	if (!ReadVarint(count)) {
+		return false;
+	}
+	for (uint64_t i = 0; i < count; i++) {
+		obs_data_t *obj = obs_data_create();
+		const bool ok = ReadObject(obj, depth + 1);
+		if (ok) {
+			obs_data_array_push_back(array, obj);
+		}
+		obs_data_release(obj);
+		if (!ok) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool SnapshotReader::ReadItem(obs_data_t *obj, const char *name, int depth)
+{
+	uint8_t type;
+	if (!ReadByte(type)) {
+		return false;
+	}
+
+	switch (static_cast<ValueType>(type)) {
+	case ValueType::STRING: {
+		std::string value;
+		if (!ReadString(value)) {
+			return false;
+		}
+		obs_data_set_string(obj, name, value.c_str());
+		return true;
+	}
+	case ValueType::INT: {
+		uint64_t value;
+		if (!ReadVarint(value)) {
+			return false;
+		}
+		obs_data_set_int(obj, name,
+				 static_cast<int64_t>(value >> 1) ^
+					 -static_cast<int64_t>(value & 1));
+		return true;
+	}
+	case ValueType::DOUBLE: {
+		double value;
+		if (!ReadDouble(value)) {
+			return false;
+		}
+		obs_data_set_double(obj, name, value);
+		return true;
+	}
+	case ValueType::BOOL_FALSE:
+	case ValueType::BOOL_TRUE:
+		obs_data_set_bool(obj, name,
+				  static_cast<ValueType>(type) ==
+					  ValueType::BOOL_TRUE);
+		return true;
+	case ValueType::OBJECT: {
+		obs_data_t *value = obs_data_create();
+		const bool ok = ReadObject(value, depth + 1);
+		if (ok) {
+			obs_data_set_obj(obj, name, value);
+		}
+		obs_data_release(value);
+		return ok;
+	}
+	case ValueType::ARRAY: {
+		obs_data_array_t *value = obs_data_array_create();
+		const bool ok = ReadArray(value, depth);
+		if (ok) {
+			obs_data_set_array(obj, name, value);
+		}
+		obs_data_array_release(value);
+		return ok;
+	}
+	default:
+		break;
+	}
+	return false;
+}
+
+bool SnapshotReader::ReadObject(obs_data_t *obj, int depth)
+{
+	if (depth > maxNestingDepth) {
+		return false;
+	}
+	uint64_t count;
+	if (!ReadVarint(count)) {
+		return false;
+	}
+	std::string name;
+	for (uint64_t i = 0; i < count; i++) {
+		if (!ReadString(name) || !ReadItem(obj, name.c_str(), depth)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool IsSettingsSnapshot(const char *data, size_t size)
+{
+	return size >= headerSize &&
+	       memcmp(data, snapshotMagic, sizeof(snapshotMagic)) == 0;
+}
+
+obs_data_t *DecodeSettingsSnapshot(const char *data, size_t size)
+{
+	if (!IsSettingsSnapshot(data, size)) {
+		return nullptr;
+	}
+
+	uint32_t version = 0;
+	for (size_t i = 0; i < sizeof(uint32_t); i++) {
+		version |= static_cast<uint32_t>(static_cast<uint8_t>(
+				   data[sizeof(snapshotMagic) + i]))
+			   << (8 * i);
+	}
+	if (version > snapshotVersion) {
+		blog(LOG_WARNING, "unsupported settings snapshot version %u",
+		     version);
+		return nullptr;
+	}
+
+	SnapshotReader reader(data + headerSize, size - headerSize);
+	obs_data_t *obj = obs_data_create();
+	if (!reader.ReadObject(obj, 0) || !reader.AtEnd()) {
+		blog(LOG_WARNING, "settings snapshot is malformed");
+		obs_data_release(obj);
+		return nullptr;
+	}
+	return obj;
+}
+
+static obs_data_t *createDataFromJson(QByteArray json)
+{
+	// obs_data_create_from_json_file() tolerates a leading UTF-8 BOM
+	static const QByteArray bom("\xEF\xBB\xBF");
+	if (json.startsWith(bom)) {
+		json.remove(0, bom.size());
+	}
+	return obs_data_create_from_json(json.constData());
+}
+
+bool SaveSettingsSnapshot(obs_data_t *obj, const QString &path)
+{
+	QFile file(path);
+	if (!file.open(QIODevice::WriteOnly)) {
+		return false;
+	}
+	const auto data = EncodeSettingsSnapshot(obj);
+	return file.write(data) == data.size();
+}
+
+obs_data_t *LoadSettingsSnapshot(const QString &path)
+{
+	QFile file(path);
+	if (!file.open(QIODevice::ReadOnly)) {
+		return nullptr;
+	}
+
+	const auto size = file.size();
+	uchar *mapped = file.map(0, size);
+	if (!mapped) {
+		const auto data = file.readAll();
+		if (IsSettingsSnapshot(data.constData(), data.size())) {
+			return DecodeSettingsSnapshot(data.constData(),
+						      data.size());
+		}
+		return createDataFromJson(data);
+	}
+
+	const char *data = reinterpret_cast<const char *>(mapped);
+	obs_data_t *obj = nullptr;
+	if (IsSettingsSnapshot(data, size)) {
+		obj = DecodeSettingsSnapshot(data, size);
+	} else {
+		// JSON files are not guaranteed to be null terminated
+		obj = createDataFromJson(
+			QByteArray(data, static_cast<int>(size)));
+	}
+	file.unmap(mapped);
+	return obj;
+}
+
+} // namespace advss
@@ -0,0 +1,23 @@
+#pragma once
+#include <obs.hpp>
+#include <QByteArray>
+#include <QString>
+
+namespace advss {
+
+// Compact, versioned binary representation of settings stored in obs_data.
+// Decoding a snapshot directly creates the obs_data objects and thus avoids
+// the cost of parsing large JSON documents.
+// Only user values are stored, so converting JSON to a snapshot and back
+// results in the same settings.
+
+QByteArray EncodeSettingsSnapshot(obs_data_t *obj);
+// Returns nullptr if the data is not a valid snapshot
+obs_data_t *DecodeSettingsSnapshot(const char *data, size_t size);
+bool IsSettingsSnapshot(const char *data, size_t size);
+
+bool SaveSettingsSnapshot(obs_data_t *obj, const QString &path);
+// Falls back to reading the file as JSON if it is not a snapshot
+obs_data_t *LoadSettingsSnapshot(const QString &path);
+
+} // namespace advss
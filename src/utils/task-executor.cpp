@@ -0,0 +1,123 @@
+#include "task-executor.hpp"
+
+namespace advss {
+
+// The executor the current thread belongs to and how many blocking scopes are
+// active on it, as only the outermost scope has to mark the thread as blocked
+static thread_local TaskExecutor *currentExecutor = nullptr;
+static thread_local int blockingScopeDepth = 0;
+
+TaskExecutor::TaskExecutor(size_t threadCount)
+	: _threadCount(threadCount > 0 ? threadCount : 1)
+{
+}
+
+TaskExecutor::~TaskExecutor()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_cv.notify_all();
+	for (auto &[_, thread] : _threads) {
+		if (thread.joinable()) {
+			thread.join();
+		}
+	}
+}
+
+void TaskExecutor::Post(Task task)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_tasks.emplace_back(std::move(task));
+		while (_runningThreads - _blockedThreads < _threadCount) {
+			StartThread();
+		}
+	}
+	_cv.notify_one();
+}
+
+void TaskExecutor::StartThread()
+{
+	for (const auto &id : _exitedThreads) {
+		auto it = _threads.find(id);
+		if (it != _threads.end()) {
+			it->second.join();
+			_threads.erase(it);
+		}
+	}
+	_exitedThreads.clear();
+
+	// The new thread cannot access the map before the lock is released
+	std::thread thread(&TaskExecutor::Thread, this);
+	const auto id = thread.get_id();
+	_threads.emplace(id, std::move(thread));
+	++_runningThreads;
+}
+
+void TaskExecutor::BeginBlocking()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	++_blockedThreads;
+	if (!_stop && _runningThreads - _blockedThreads < _threadCount) {
+		StartThread();
+	}
+}
+
+void TaskExecutor::EndBlocking()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	--_blockedThreads;
+}
+
+void TaskExecutor::Thread()
+{
+	currentExecutor = this;
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (true) {
+		_cv.wait(lock, [this]() { return _stop || !_tasks.empty(); });
+		if (_stop) {
+			return;
+		}
+		auto task = std::move(_tasks.front());
+		_tasks.pop_front();
+		lock.unlock();
+		task();
+		lock.lock();
+
+		// Threads started in place of blocked threads are no longer
+		// needed once the blocked threads continue
+		if (!_stop &&
+		    _runningThreads - _blockedThreads > _threadCount) {
+			--_runningThreads;
+			_exitedThreads.push_back(std::this_thread::get_id());
+			if (!_tasks.empty()) {
+				_cv.notify_one();
+			}
+			return;
+		}
+	}
+}
+
+TaskExecutor::BlockingScope::BlockingScope()
+{
+	if (!currentExecutor || blockingScopeDepth++ > 0) {
+		return;
+	}
+	_executor = currentExecutor;
+	_executor->BeginBlocking();
+}
+
+TaskExecutor::BlockingScope::~BlockingScope()
+{
+	if (!currentExecutor) {
+		return;
+	}
+	--blockingScopeDepth;
+	if (_executor) {
+		_executor->EndBlocking();
+	}
+}
+
+} // namespace advss
@@ -0,0 +1,61 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace advss {
+
+// Runs tasks on a fixed number of threads, which are only started once the
+// first task is posted.
+// Threads waiting inside of a BlockingScope do not count towards that number.
+// Tasks which are still queued once the executor is destroyed are dropped.
+class TaskExecutor {
+public:
+	using Task = std::function<void()>;
+
+	TaskExecutor(size_t threadCount);
+	~TaskExecutor();
+	TaskExecutor(const TaskExecutor &) = delete;
+	TaskExecutor &operator=(const TaskExecutor &) = delete;
+
+	void Post(Task);
+
+	// Marks the calling thread as blocked while the scope is active, if it
+	// is a thread of an executor.
+	// Another thread is started in its place, so tasks blocking while
+	// waiting for other tasks cannot starve or deadlock the executor.
+	// Additional threads exit again once they are no longer needed.
+	class BlockingScope {
+	public:
+		BlockingScope();
+		~BlockingScope();
+		BlockingScope(const BlockingScope &) = delete;
+		BlockingScope &operator=(const BlockingScope &) = delete;
+
+	private:
+		TaskExecutor *_executor = nullptr;
+	};
+
+private:
+	void Thread();
+	void StartThread();
+	void BeginBlocking();
+	void EndBlocking();
+
+	const size_t _threadCount;
+	std::unordered_map<std::thread::id, std::thread> _threads;
+	// Threads which exited and still have to be joined
+	std::vector<std::thread::id> _exitedThreads;
+	size_t _runningThreads = 0;
+	size_t _blockedThreads = 0;
+	std::deque<Task> _tasks;
+	std::mutex _mutex;
+	std::condition_variable _cv;
+	bool _stop = false;
+};
+
+} // namespace advss
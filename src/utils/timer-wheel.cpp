@@ -0,0 +1,219 @@
+#include "timer-wheel.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace advss {
+
+TimerWheel::~TimerWheel()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_cv.notify_all();
+	if (_thread.joinable()) {
+		_thread.join();
+	}
+}
+
+TimerWheel::TimerId
+TimerWheel::Schedule(std::chrono::steady_clock::time_point deadline,
+		     Callback callback)
+{
+	TimerId id;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		id = _nextId++;
+		auto &timer = _timers[id];
+		// Round up, so the callback is never called too early
+		timer.expiryTick = GetTick(deadline + std::chrono::nanoseconds(
+							      999999));
+		// The slot of the current tick was already processed
+		timer.expiryTick = std::max(timer.expiryTick, _currentTick + 1);
+		timer.callback = std::move(callback);
+		Insert(id, timer);
+		if (!_thread.joinable()) {
+			_thread = std::thread(&TimerWheel::Thread, this);
+		}
+	}
+	_cv.notify_all();
+	return id;
+}
+
+void TimerWheel::Cancel(TimerId id)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	auto it = _timers.find(id);
+	if (it != _timers.end()) {
+		Unlink(id, it->second);
+		_timers.erase(it);
+	}
+	// Callbacks cancelling their own timer must not wait for themselves
+	if (std::this_thread::get_id() == _thread.get_id()) {
+		return;
+	}
+	_callbackDone.wait(lock, [this, id]() { return _runningTimer != id; });
+}
+
+uint64_t TimerWheel::GetTick(std::chrono::steady_clock::time_point time) const
+{
+	if (time <= _start) {
+		return 0;
+	}
+	return std::chrono::duration_cast<std::chrono::milliseconds>(time -
+								     _start)
+		.count();
+}
+
+void TimerWheel::Insert(TimerId id, Timer &timer)
+{
+	const uint64_t delta = timer.expiryTick > _currentTick
+				       ? timer.expiryTick - _currentTick
+				       : 0;
+	size_t level = 0;
+	while (level + 1 < levelCount &&
+	       delta >= (uint64_t(1) << (levelBits * (level + 1)))) {
+		++level;
+	}
+	uint64_t tick = timer.expiryTick;
+	const uint64_t maxDelta = (uint64_t(1) << (levelBits * levelCount)) - 1;
+	if (delta > maxDelta) {
+		// Too far in the future for the wheel, so it will be inserted
+		// again once the last level reaches it
+		tick = _currentTick + maxDelta;
+	}
+
+	timer.level = level;
+	timer.slot = (tick >> (levelBits * level)) & slotMask;
+	auto &wheelLevel = _levels[level];
+	wheelLevel.slots[timer.slot].push_back(id);
+	wheelLevel.occupied.set(timer.slot);
+	++wheelLevel.count;
+}
+
+void TimerWheel::Unlink(TimerId id, const Timer &timer)
+{
+	// Timers which are due are no longer part of the wheel
+	if (timer.level >= levelCount) {
+		return;
+	}
+	auto &level = _levels[timer.level];
+	auto &slot = level.slots[timer.slot];
+	auto it = std::find(slot.begin(), slot.end(), id);
+	if (it == slot.end()) {
+		return;
+	}
+	*it = slot.back();
+	slot.pop_back();
+	--level.count;
+	if (slot.empty()) {
+		level.occupied.reset(timer.slot);
+	}
+}
+
+void TimerWheel::Cascade(size_t levelIdx, size_t slotIdx)
+{
+	auto &level = _levels[levelIdx];
+	std::vector<TimerId> ids;
+	ids.swap(level.slots[slotIdx]);
+	level.occupied.reset(slotIdx);
+	level.count -= ids.size();
+	for (const auto id : ids) {
+		Insert(id, _timers[id]);
+	}
+}
+
+uint64_t TimerWheel::GetNextEventTick() const
+{
+	uint64_t next = std::numeric_limits<uint64_t>::max();
+	const auto &firstLevel = _levels[0];
+	if (firstLevel.count > 0) {
+		for (uint64_t offset = 1; offset <= slotCount; offset++) {
+			if (firstLevel.occupied[(_currentTick + offset) &
+						slotMask]) {
+				next = _currentTick + offset;
+				break;
+			}
+		}
+	}
+
+	// Timers of the other levels are moved to a finer level once the
+	// current tick reaches the start of their slot
+	for (size_t level = 1; level < levelCount; level++) {
+		if (_levels[level].count == 0) {
+			continue;
+		}
+		const int shift = levelBits * static_cast<int>(level);
+		next = std::min(next, ((_currentTick >> shift) + 1) << shift);
+		break;
+	}
+	return next;
+}
+
+void TimerWheel::Advance(uint64_t tick, std::vector<TimerId> &due)
+{
+	// Skip all ticks without any events instead of processing each one
+	uint64_t next;
+	while ((next = GetNextEventTick()) <= tick) {
+		_currentTick = next;
+		// Higher levels first, as their timers might be moved to lower
+		// levels which are due at this tick as well
+		for (size_t level = levelCount - 1; level > 0; level--) {
+			const int shift = levelBits * static_cast<int>(level);
+			const uint64_t mask = (uint64_t(1) << shift) - 1;
+			if ((next & mask) == 0) {
+				Cascade(level, (next >> shift) & slotMask);
+			}
+		}
+
+		auto &firstLevel = _levels[0];
+		const size_t slotIdx = next & slotMask;
+		auto &slot = firstLevel.slots[slotIdx];
+		for (const auto id : slot) {
+			_timers[id].level = levelCount;
+			due.push_back(id);
+		}
+		firstLevel.count -= slot.size();
+		firstLevel.occupied.reset(slotIdx);
+		slot.clear();
+	}
+	_currentTick = std::max(_currentTick, tick);
+}
+
+void TimerWheel::Thread()
+{
+	std::vector<TimerId> due;
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (!_stop) {
+		Advance(GetTick(std::chrono::steady_clock::now()), due);
+		for (const auto id : due) {
+			// The timer might have been cancelled in the meantime
+			auto it = _timers.find(id);
+			if (it == _timers.end()) {
+				continue;
+			}
+			auto callback = std::move(it->second.callback);
+			_timers.erase(it);
+			_runningTimer = id;
+			lock.unlock();
+			callback();
+			lock.lock();
+			_runningTimer = 0;
+			_callbackDone.notify_all();
+		}
+		due.clear();
+
+		if (_stop) {
+			break;
+		}
+		if (_timers.empty()) {
+			_cv.wait(lock);
+			continue;
+		}
+		const auto next = GetNextEventTick();
+		_cv.wait_until(lock, _start + std::chrono::milliseconds(next));
+	}
+}
+
+} // namespace advss
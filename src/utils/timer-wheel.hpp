@@ -0,0 +1,77 @@
+#pragma once
+#include <array>
+#include <bitset>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace advss {
+
+// Runs callbacks once their deadline has passed using a single thread.
+// Timers are sorted into a hierarchical timing wheel with a resolution of one
+// millisecond, so adding and cancelling a timer takes constant time no matter
+// how many timers are active, and the thread only wakes up when a timer is
+// due or has to be moved to a finer level of the wheel.
+class TimerWheel {
+public:
+	using TimerId = uint64_t;
+	using Callback = std::function<void()>;
+
+	TimerWheel() = default;
+	~TimerWheel();
+	TimerWheel(const TimerWheel &) = delete;
+	TimerWheel &operator=(const TimerWheel &) = delete;
+
+	TimerId Schedule(std::chrono::steady_clock::time_point deadline,
+			 Callback callback);
+	// Once this returns the callback will not be called anymore and is no
+	// longer running
+	void Cancel(TimerId id);
+
+private:
+	static constexpr int levelBits = 8;
+	static constexpr size_t slotCount = 1 << levelBits;
+	static constexpr uint64_t slotMask = slotCount - 1;
+	static constexpr size_t levelCount = 4;
+
+	struct Timer {
+		uint64_t expiryTick = 0;
+		size_t level = 0;
+		size_t slot = 0;
+		Callback callback;
+	};
+	struct Level {
+		std::array<std::vector<TimerId>, slotCount> slots;
+		std::bitset<slotCount> occupied;
+		size_t count = 0;
+	};
+
+	void Thread();
+	uint64_t GetTick(std::chrono::steady_clock::time_point) const;
+	uint64_t GetNextEventTick() const;
+	void Insert(TimerId, Timer &);
+	void Unlink(TimerId, const Timer &);
+	void Cascade(size_t level, size_t slot);
+	void Advance(uint64_t tick, std::vector<TimerId> &due);
+
+	const std::chrono::steady_clock::time_point _start =
+		std::chrono::steady_clock::now();
+	uint64_t _currentTick = 0;
+	TimerId _nextId = 1;
+	std::array<Level, levelCount> _levels;
+	std::unordered_map<TimerId, Timer> _timers;
+
+	std::mutex _mutex;
+	std::condition_variable _cv;
+	std::condition_variable _callbackDone;
+	TimerId _runningTimer = 0;
+	std::thread _thread;
+	bool _stop = false;
+};
+
+} // namespace advss
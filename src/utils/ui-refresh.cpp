@@ -0,0 +1,109 @@
+#include "ui-refresh.hpp"
+#include "switcher-data.hpp"
+#include "utility.hpp"
+
+#include <QPointer>
+#include <QTimer>
+#include <algorithm>
+#include <vector>
+
+namespace advss {
+
+constexpr auto tickInterval = std::chrono::milliseconds(250);
+
+namespace {
+
+struct Registration {
+	QPointer<QWidget> widget;
+	UIRefreshCallback callback;
+	int ticksPerRefresh;
+	int ticksUntilRefresh;
+};
+
+} // namespace
+
+static QTimer *timer = nullptr;
+static std::vector<Registration> registrations;
+static UIRefreshSnapshot snapshot;
+
+static void updateSnapshot()
+{
+	snapshot.cursorPosition = GetCursorPos();
+	snapshot.currentDateTime = QDateTime::currentDateTime();
+	if (!switcher) {
+		snapshot.switcherRunning = false;
+		return;
+	}
+	snapshot.switcherRunning = switcher->th && switcher->th->isRunning();
+
+	// Never block the UI thread while the switcher thread is busy and
+	// rather show the values of the previous refresh instead
+	std::unique_lock<std::mutex> lock(switcher->m, std::try_to_lock);
+	if (!lock.owns_lock()) {
+		return;
+	}
+	snapshot.foregroundWindowTitle = switcher->currentTitle;
+	snapshot.foregroundProcess = switcher->currentForegroundProcess;
+}
+
+static void tick()
+{
+	std::vector<std::pair<QPointer<QWidget>, UIRefreshCallback>> due;
+	for (auto &registration : registrations) {
+		if (!registration.widget ||
+		    --registration.ticksUntilRefresh > 0) {
+			continue;
+		}
+		registration.ticksUntilRefresh = registration.ticksPerRefresh;
+		if (!registration.widget->isVisible()) {
+			continue;
+		}
+		due.emplace_back(registration.widget, registration.callback);
+	}
+
+	if (!due.empty()) {
+		updateSnapshot();
+		// Callbacks might register new widgets or destroy existing ones
+		for (const auto &[widget, callback] : due) {
+			if (widget) {
+				callback(snapshot);
+			}
+		}
+	}
+
+	registrations.erase(std::remove_if(registrations.begin(),
+					   registrations.end(),
+					   [](const Registration &r) {
+						   return !r.widget;
+					   }),
+			    registrations.end());
+	if (registrations.empty()) {
+		timer->stop();
+	}
+}
+
+void RegisterUIRefresh(QWidget *widget, const UIRefreshCallback &callback,
+		       std::chrono::milliseconds interval)
+{
+	if (!timer) {
+		timer = new QTimer();
+		timer->setInterval(static_cast<int>(tickInterval.count()));
+		QObject::connect(timer, &QTimer::timeout, tick);
+	}
+
+	const int ticks = std::max(1, static_cast<int>(interval.count() /
+						       tickInterval.count()));
+	registrations.push_back({widget, callback, ticks, ticks});
+	if (!timer->isActive()) {
+		timer->start();
+	}
+}
+
+void CleanupUIRefresh()
+{
+	delete timer;
+	timer = nullptr;
+	registrations.clear();
+}
+
+} // namespace advss
@@ -0,0 +1,33 @@
+#pragma once
+#include <QDateTime>
+#include <QWidget>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <utility>
+
+namespace advss {
+
+// State frequently displayed by widgets, which is collected only once per
+// refresh for all of them
+struct UIRefreshSnapshot {
+	std::string foregroundWindowTitle;
+	std::string foregroundProcess;
+	std::pair<int, int> cursorPosition;
+	QDateTime currentDateTime;
+	bool switcherRunning = false;
+};
+
+using UIRefreshCallback = std::function<void(const UIRefreshSnapshot &)>;
+
+// Calls the callback periodically from a timer shared by all widgets.
+// The callback is skipped while the widget is hidden and the registration is
+// removed once the widget is destroyed.
+// Must be called from the UI thread.
+void RegisterUIRefresh(QWidget *widget, const UIRefreshCallback &callback,
+		       std::chrono::milliseconds interval =
+			       std::chrono::milliseconds(1000));
+// Stops the shared timer and drops all registrations
+void CleanupUIRefresh();
+
+} // namespace advss
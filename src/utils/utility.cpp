@@ -1259,8 +1259,30 @@ int FindIdxInRagne(QComboBox *list, int start, int stop,
 	return foundIdx;
 }
 
+// Converts native pixels to the device independent pixels used by QCursor
+static std::pair<int, int> toDeviceIndependentPos(int x, int y)
+{
+	for (const auto screen : QGuiApplication::screens()) {
+		// The top left corner of a screen is the same in both
+		const auto geometry = screen->geometry();
+		const qreal ratio = screen->devicePixelRatio();
+		const QRect nativeGeometry(geometry.topLeft(),
+					   geometry.size() * ratio);
+		if (!nativeGeometry.contains(x, y)) {
+			continue;
+		}
+		return {geometry.x() + qRound((x - geometry.x()) / ratio),
+			geometry.y() + qRound((y - geometry.y()) / ratio)};
+	}
+	return {x, y};
+}
+
 std::pair<int, int> GetCursorPos()
 {
+	if (auto trackedPos = GetTrackedCursorPos()) {
+		return toDeviceIndependentPos(trackedPos->first,
+					      trackedPos->second);
+	}
 	auto cursorPos = QCursor::pos();
 	return {cursorPos.x(), cursorPos.y()};
 }
@@ -13,7 +13,12 @@ void StringVariable::Resolve() const
 	if (_lastResolve == GetLastVariableChangeTime()) {
 		return;
 	}
-	_resolvedValue = SubstitueVariables(_value);
+	if (_value.find("${") == std::string::npos) {
+		// Reuses the already allocated buffer of _resolvedValue
+		_resolvedValue = _value;
+	} else {
+		_resolvedValue = SubstitueVariables(_value);
+	}
 	_lastResolve = GetLastVariableChangeTime();
 }
 
@@ -69,9 +74,20 @@ std::string SubstitueVariables(std::string str)
 		return str;
 	}
 
+	// The pattern buffer is reused to avoid allocating a new string for
+	// each variable on every call
+	thread_local std::string pattern;
 	for (const auto &v : switcher->variables) {
-		const auto &variable = std::dynamic_pointer_cast<Variable>(v);
-		const std::string pattern = "${" + variable->Name() + "}";
+		if (str.find("${") == std::string::npos) {
+			break;
+		}
+		const auto variable = dynamic_cast<Variable *>(v.get());
+		pattern.assign("${");
+		pattern.append(variable->Name());
+		pattern.push_back('}');
+		if (str.find(pattern) == std::string::npos) {
+			continue;
+		}
 		ReplaceAll(str, pattern, variable->Value());
 	}
 	return str;
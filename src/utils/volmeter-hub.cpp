@@ -0,0 +1,310 @@
+#include "volmeter-hub.hpp"
+#include "log-helper.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <unordered_map>
+#include <util/platform.h>
+
+namespace advss {
+
+static std::mutex hubMutex;
+static std::unordered_map<obs_weak_source_t *, std::weak_ptr<VolmeterHub>>
+	hubs;
+
+VolmeterHub::VolmeterHub(const OBSWeakSource &source)
+	: _source(source), _volmeter(obs_volmeter_create(OBS_FADER_LOG))
+{
+	obs_volmeter_add_callback(_volmeter, SetVolumeLevel, this);
+	OBSSourceAutoRelease as = obs_weak_source_get_source(source);
+	if (!obs_volmeter_attach_source(_volmeter, as)) {
+		const char *name = obs_source_get_name(as);
+		blog(LOG_WARNING, "failed to attach volmeter to source %s",
+		     name);
+	}
+}
+
+VolmeterHub::~VolmeterHub()
+{
+	obs_volmeter_remove_callback(_volmeter, SetVolumeLevel, this);
+	obs_volmeter_destroy(_volmeter);
+
+	std::lock_guard<std::mutex> lock(hubMutex);
+	auto it = hubs.find(_source);
+	if (it != hubs.end() && it->second.expired()) {
+		hubs.erase(it);
+	}
+}
+
+std::shared_ptr<VolmeterHub> VolmeterHub::Get(const OBSWeakSource &source)
+{
+	if (!source) {
+		return {};
+	}
+
+	std::lock_guard<std::mutex> lock(hubMutex);
+	auto &entry = hubs[source];
+	auto hub = entry.lock();
+	if (!hub) {
+		hub = std::shared_ptr<VolmeterHub>(new VolmeterHub(source));
+		entry = hub;
+	}
+	return hub;
+}
+
+uint64_t VolmeterHub::CurrentWindow()
+{
+	return os_gettime_ns() / windowNs;
+}
+
+float VolmeterHub::GetPeak(uint64_t from, uint64_t to) const
+{
+	if (to > from && to - from > windowCount) {
+		from = to - windowCount;
+	}
+
+	float result = -std::numeric_limits<float>::infinity();
+	for (uint64_t idx = from; idx < to; idx++) {
+		const auto &w = _windows[idx % windowCount];
+		if (w.window.load(std::memory_order_acquire) != idx) {
+			continue;
+		}
+		const float peak = w.peak.load(std::memory_order_acquire);
+		// Window might have been recycled by the audio thread meanwhile
+		if (w.window.load(std::memory_order_acquire) != idx) {
+			continue;
+		}
+		result = std::max(result, peak);
+	}
+	return result;
+}
+
+void VolmeterHub::AddPeak(float peak, uint64_t window)
+{
+	auto &w = _windows[window % windowCount];
+	if (w.window.load(std::memory_order_relaxed) != window) {
+		w.window.store(UINT64_MAX, std::memory_order_release);
+		w.peak.store(-std::numeric_limits<float>::infinity(),
+			     std::memory_order_release);
+		w.window.store(window, std::memory_order_release);
+	}
+	if (peak > w.peak.load(std::memory_order_relaxed)) {
+		w.peak.store(peak, std::memory_order_release);
+	}
+}
+
+static float dbToMul(float db)
+{
+	return std::isfinite(db) ? std::pow(10.0f, db / 20.0f)
+				 : (db > 0.0f ? db : 0.0f);
+}
+
+static float mulToDb(float mul)
+{
+	return mul == 0.0f ? -std::numeric_limits<float>::infinity()
+			   : 20.0f * std::log10(mul);
+}
+
+void VolmeterHub::AddSample(float magnitude, float peak, uint64_t timestamp)
+{
+	const auto mul = dbToMul(magnitude);
+	_sumSquares += (double)mul * mul;
+
+	const auto idx = _sampleCount.load(std::memory_order_relaxed);
+	auto &slot = _samples[idx % sampleCount];
+	slot.idx.store(UINT64_MAX, std::memory_order_release);
+	slot.timestamp.store(timestamp, std::memory_order_release);
+	slot.magnitude.store(magnitude, std::memory_order_release);
+	slot.peak.store(peak, std::memory_order_release);
+	slot.sumSquares.store(_sumSquares, std::memory_order_release);
+	slot.idx.store(idx, std::memory_order_release);
+	_sampleCount.store(idx + 1, std::memory_order_release);
+}
+
+bool VolmeterHub::GetSample(uint64_t idx, AudioLevelSample &sample) const
+{
+	const auto &slot = _samples[idx % sampleCount];
+	if (slot.idx.load(std::memory_order_acquire) != idx) {
+		return false;
+	}
+	sample.timestamp = slot.timestamp.load(std::memory_order_acquire);
+	sample.magnitude = slot.magnitude.load(std::memory_order_acquire);
+	sample.peak = slot.peak.load(std::memory_order_acquire);
+	sample.sumSquares = slot.sumSquares.load(std::memory_order_acquire);
+	// Slot might have been recycled by the audio thread meanwhile
+	return slot.idx.load(std::memory_order_acquire) == idx;
+}
+
+std::pair<uint64_t, uint64_t>
+VolmeterHub::GetSamplesSince(uint64_t timestamp) const
+{
+	const auto end = _sampleCount.load(std::memory_order_acquire);
+	// Leave some headroom for slots being overwritten during the search
+	const uint64_t available = sampleCount - sampleCount / 8;
+	uint64_t first = end > available ? end - available : 0;
+
+	// Timestamps are monotonic so a binary search can be used
+	uint64_t low = first;
+	uint64_t high = end;
+	AudioLevelSample sample;
+	while (low < high) {
+		const uint64_t mid = low + (high - low) / 2;
+		if (!GetSample(mid, sample) || sample.timestamp < timestamp) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+	return {low, end};
+}
+
+void VolmeterHub::SetVolumeLevel(void *data,
+				 const float magnitude[MAX_AUDIO_CHANNELS],
+				 const float peak[MAX_AUDIO_CHANNELS],
+				 const float *)
+{
+	auto hub = static_cast<VolmeterHub *>(data);
+	float maxPeak = -std::numeric_limits<float>::infinity();
+	float maxMagnitude = -std::numeric_limits<float>::infinity();
+	for (int i = 0; i < MAX_AUDIO_CHANNELS; i++) {
+		if (peak[i] > maxPeak) {
+			maxPeak = peak[i];
+		}
+		if (magnitude[i] > maxMagnitude) {
+			maxMagnitude = magnitude[i];
+		}
+	}
+	const auto timestamp = os_gettime_ns();
+	hub->AddPeak(maxPeak, timestamp / windowNs);
+	hub->AddSample(maxMagnitude, maxPeak, timestamp);
+}
+
+AudioLevelReader::AudioLevelReader(const OBSWeakSource &source)
+{
+	SetSource(source);
+}
+
+void AudioLevelReader::SetSource(const OBSWeakSource &source)
+{
+	if (_hub && _hub->GetSource() == source) {
+		return;
+	}
+	_hub = VolmeterHub::Get(source);
+	ResetPeak();
+}
+
+OBSWeakSource AudioLevelReader::GetSource() const
+{
+	return _hub ? _hub->GetSource() : OBSWeakSource();
+}
+
+float AudioLevelReader::GetPeakSinceLastRead()
+{
+	// The current window is still being filled, so it is only part of the
+	// next read
+	const auto current = VolmeterHub::CurrentWindow();
+	const auto from = _lastReadWindow;
+	_lastReadWindow = current;
+	if (!_hub) {
+		return -std::numeric_limits<float>::infinity();
+	}
+	return _hub->GetPeak(from, current);
+}
+
+void AudioLevelReader::ResetPeak(std::chrono::milliseconds lookBack)
+{
+	const uint64_t windows =
+		std::chrono::duration_cast<std::chrono::nanoseconds>(lookBack)
+			.count() /
+		VolmeterHub::windowNs;
+	_lastReadWindow = VolmeterHub::CurrentWindow() - windows;
+}
+
+std::pair<uint64_t, uint64_t>
+AudioLevelReader::GetSamples(std::chrono::milliseconds window) const
+{
+	if (!_hub) {
+		return {0, 0};
+	}
+	const uint64_t windowNs =
+		std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::min(window, maxWindow))
+			.count();
+	const uint64_t now = os_gettime_ns();
+	return _hub->GetSamplesSince(now > windowNs ? now - windowNs : 0);
+}
+
+float AudioLevelReader::GetPeak(std::chrono::milliseconds window) const
+{
+	float result = -std::numeric_limits<float>::infinity();
+	const auto [first, end] = GetSamples(window);
+	AudioLevelSample sample;
+	for (uint64_t idx = first; idx < end; idx++) {
+		if (_hub->GetSample(idx, sample)) {
+			result = std::max(result, sample.peak);
+		}
+	}
+	return result;
+}
+
+float AudioLevelReader::GetRMS(std::chrono::milliseconds window) const
+{
+	const auto [first, end] = GetSamples(window);
+	AudioLevelSample firstSample, lastSample;
+	if (first >= end || !_hub->GetSample(first, firstSample) ||
+	    !_hub->GetSample(end - 1, lastSample)) {
+		return -std::numeric_limits<float>::infinity();
+	}
+
+	// The running sums allow calculating the RMS of any window in O(1)
+	const auto firstMul = dbToMul(firstSample.magnitude);
+	const double sum = lastSample.sumSquares - firstSample.sumSquares +
+			   (double)firstMul * firstMul;
+	const auto count = end - first;
+	return mulToDb((float)std::sqrt(std::max(sum, 0.) / count));
+}
+
+float AudioLevelReader::GetPercentile(std::chrono::milliseconds window,
+				      double percentile) const
+{
+	const auto [first, end] = GetSamples(window);
+	_magnitudes.clear();
+	AudioLevelSample sample;
+	for (uint64_t idx = first; idx < end; idx++) {
+		if (_hub->GetSample(idx, sample)) {
+			_magnitudes.push_back(sample.magnitude);
+		}
+	}
+	if (_magnitudes.empty()) {
+		return -std::numeric_limits<float>::infinity();
+	}
+
+	percentile = std::clamp(percentile, 0., 100.);
+	const size_t pos = (size_t)std::lround(percentile / 100. *
+					       (_magnitudes.size() - 1));
+	std::nth_element(_magnitudes.begin(), _magnitudes.begin() + pos,
+			 _magnitudes.end());
+	return _magnitudes[pos];
+}
+
+double AudioLevelReader::GetRatioAbove(std::chrono::milliseconds window,
+				       float threshold) const
+{
+	const auto [first, end] = GetSamples(window);
+	size_t count = 0;
+	size_t above = 0;
+	AudioLevelSample sample;
+	for (uint64_t idx = first; idx < end; idx++) {
+		if (!_hub->GetSample(idx, sample)) {
+			continue;
+		}
+		count++;
+		if (sample.magnitude > threshold) {
+			above++;
+		}
+	}
+	return count == 0 ? 0. : (double)above / count;
+}
+
+} // namespace advss
@@ -0,0 +1,118 @@
+#pragma once
+#include <obs.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace advss {
+
+struct AudioLevelSample {
+	uint64_t timestamp = 0;
+	// Highest per channel magnitude and peak of the volmeter update in dB
+	float magnitude = 0.f;
+	float peak = 0.f;
+	// Running sum of the squared linear magnitudes up to this sample
+	double sumSquares = 0.;
+};
+
+// Owns the single volmeter of an audio source.
+// All AudioLevelReader instances referring to the same source share one hub,
+// so the audio thread only has to process one volmeter callback per source
+// regardless of how many conditions are checking its volume.
+class VolmeterHub {
+public:
+	~VolmeterHub();
+	static std::shared_ptr<VolmeterHub> Get(const OBSWeakSource &source);
+
+	OBSWeakSource GetSource() const { return _source; }
+	static uint64_t CurrentWindow();
+	// Highest peak in dB of all windows in the range [from, to)
+	float GetPeak(uint64_t from, uint64_t to) const;
+
+	// Samples are numbered in the order of the volmeter updates.
+	// Returns the range [first, end) of samples still available which were
+	// recorded at or after the given timestamp.
+	std::pair<uint64_t, uint64_t> GetSamplesSince(uint64_t timestamp) const;
+	bool GetSample(uint64_t idx, AudioLevelSample &sample) const;
+
+	static constexpr uint64_t windowNs = 10000000; // 10ms
+	static constexpr size_t windowCount = 1024;
+	// Volmeter updates happen roughly every 21ms so this covers a minute
+	static constexpr size_t sampleCount = 4096;
+	// Longest time span GetSamplesSince() can reliably provide samples for
+	static constexpr std::chrono::seconds maxSampleAge{60};
+
+private:
+	VolmeterHub(const OBSWeakSource &source);
+	static void SetVolumeLevel(void *data,
+				   const float magnitude[MAX_AUDIO_CHANNELS],
+				   const float peak[MAX_AUDIO_CHANNELS],
+				   const float inputPeak[MAX_AUDIO_CHANNELS]);
+	void AddPeak(float peak, uint64_t window);
+	void AddSample(float magnitude, float peak, uint64_t timestamp);
+
+	// Written exclusively by the audio thread
+	struct PeakWindow {
+		std::atomic<uint64_t> window = {UINT64_MAX};
+		std::atomic<float> peak = {
+			-std::numeric_limits<float>::infinity()};
+	};
+	std::array<PeakWindow, windowCount> _windows;
+
+	// Written exclusively by the audio thread
+	struct SampleSlot {
+		std::atomic<uint64_t> idx = {UINT64_MAX};
+		std::atomic<uint64_t> timestamp = {0};
+		std::atomic<float> magnitude = {0.f};
+		std::atomic<float> peak = {0.f};
+		std::atomic<double> sumSquares = {0.};
+	};
+	std::array<SampleSlot, sampleCount> _samples;
+	std::atomic<uint64_t> _sampleCount = {0};
+	double _sumSquares = 0.;
+
+	OBSWeakSource _source;
+	obs_volmeter_t *_volmeter = nullptr;
+};
+
+// Provides the peak audio level of a source since the last read and
+// statistics about the audio levels of a recent time window
+class AudioLevelReader {
+public:
+	AudioLevelReader() = default;
+	AudioLevelReader(const OBSWeakSource &source);
+
+	void SetSource(const OBSWeakSource &source);
+	OBSWeakSource GetSource() const;
+	// Returns the highest peak in dB since the last read or reset
+	float GetPeakSinceLastRead();
+	// Only consider audio levels of the given duration before this call
+	void ResetPeak(std::chrono::milliseconds lookBack = {});
+
+	// All levels are in dB and only consider the given time window before
+	// this call, which is limited to maxWindow
+	float GetPeak(std::chrono::milliseconds window) const;
+	float GetRMS(std::chrono::milliseconds window) const;
+	float GetPercentile(std::chrono::milliseconds window,
+			    double percentile) const;
+	// Fraction of time in the range [0, 1] the magnitude was above the
+	// given threshold
+	double GetRatioAbove(std::chrono::milliseconds window,
+			     float threshold) const;
+
+	static constexpr std::chrono::milliseconds maxWindow =
+		VolmeterHub::maxSampleAge;
+
+private:
+	std::pair<uint64_t, uint64_t>
+	GetSamples(std::chrono::milliseconds window) const;
+
+	std::shared_ptr<VolmeterHub> _hub;
+	uint64_t _lastReadWindow = 0;
+	mutable std::vector<float> _magnitudes;
+};
+
+} // namespace advss
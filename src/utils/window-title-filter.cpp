@@ -0,0 +1,97 @@
+#include "window-title-filter.hpp"
+
+#ifdef UNIT_TEST
+#define blog(level, msg, ...)
+#else
+#include "log-helper.hpp"
+#endif
+
+#include <iterator>
+
+namespace advss {
+
+static bool containsBackReference(const std::string &expr)
+{
+	for (size_t i = 0; i + 1 < expr.size(); i++) {
+		if (expr[i] != '\\') {
+			continue;
+		}
+		if (expr[i + 1] >= '1' && expr[i + 1] <= '9') {
+			return true;
+		}
+		// Skip the escaped character
+		i++;
+	}
+	return false;
+}
+
+void WindowTitleFilter::Update(const std::vector<std::string> &entries)
+{
+	_entries = entries;
+	_exactMatches = {entries.begin(), entries.end()};
+	_separate.clear();
+	_hasCombined = false;
+
+	std::string combined;
+	std::vector<std::regex> combinable;
+	for (const auto &entry : entries) {
+		std::regex expr;
+		try {
+			expr = std::regex(entry);
+		} catch (const std::regex_error &) {
+			// Invalid expressions can still be matched literally
+			continue;
+		}
+
+		// Renumbering the groups of the combined expression would break
+		// back references
+		if (containsBackReference(entry)) {
+			_separate.emplace_back(std::move(expr));
+			continue;
+		}
+		if (!combined.empty()) {
+			combined += '|';
+		}
+		combined += "(?:" + entry + ")";
+		combinable.emplace_back(std::move(expr));
+	}
+
+	if (combined.empty()) {
+		return;
+	}
+	try {
+		_combined = std::regex(combined, std::regex::optimize);
+		_hasCombined = true;
+	} catch (const std::regex_error &e) {
+		blog(LOG_WARNING, "failed to combine window title filters: %s",
+		     e.what());
+		std::move(combinable.begin(), combinable.end(),
+			  std::back_inserter(_separate));
+	}
+}
+
+bool WindowTitleFilter::Matches(const std::vector<std::string> &entries,
+				const std::string &title)
+{
+	if (entries.empty()) {
+		return false;
+	}
+	if (entries != _entries) {
+		Update(entries);
+	}
+
+	if (_exactMatches.count(title) > 0) {
+		return true;
+	}
+	if (_hasCombined && std::regex_match(title, _combined)) {
+		return true;
+	}
+	for (const auto &expr : _separate) {
+		if (std::regex_match(title, expr)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+} // namespace advss
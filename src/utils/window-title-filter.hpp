@@ -0,0 +1,30 @@
+#pragma once
+#include <regex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace advss {
+
+// Checks if a window title matches any entry of a list of window titles,
+// which are compared literally and also interpreted as regular expressions.
+// The entries are compiled into a single matcher, which is only rebuilt once
+// the list changes.
+class WindowTitleFilter {
+public:
+	bool Matches(const std::vector<std::string> &entries,
+		     const std::string &title);
+
+private:
+	void Update(const std::vector<std::string> &entries);
+
+	std::vector<std::string> _entries;
+	std::unordered_set<std::string> _exactMatches;
+	// All valid expressions combined into a single alternation
+	std::regex _combined;
+	bool _hasCombined = false;
+	// Expressions which cannot be combined as they contain back references
+	std::vector<std::regex> _separate;
+};
+
+} // namespace advss
@@ -26,9 +26,12 @@ bool canSimulateKeyPresses = true;
 // Mouse click
 class RawMouseInputFilter;
 RawMouseInputFilter *mouseInputFilter;
-std::chrono::high_resolution_clock::time_point lastMouseLeftClickTime{};
-std::chrono::high_resolution_clock::time_point lastMouseMiddleClickTime{};
-std::chrono::high_resolution_clock::time_point lastMouseRightClickTime{};
+std::atomic<std::chrono::high_resolution_clock::time_point>
+	lastMouseLeftClickTime{};
+std::atomic<std::chrono::high_resolution_clock::time_point>
+	lastMouseMiddleClickTime{};
+std::atomic<std::chrono::high_resolution_clock::time_point>
+	lastMouseRightClickTime{};
 
 static bool GetWindowTitle(HWND window, std::string &title)
 {
@@ -492,41 +495,26 @@ static std::unordered_map<HotkeyType, long> keyTable = {
 	{HotkeyType::Key_NumpadEnter, VK_RETURN},
 };
 
-void PressKeys(const std::vector<HotkeyType> keys, int duration)
+void SendKeyEvents(const std::vector<KeyEvent> &events)
 {
-	const int repeatInterval = 100;
-
-	INPUT ip;
-	ip.type = INPUT_KEYBOARD;
-	ip.ki.wScan = 0;
-	ip.ki.time = 0;
-	ip.ki.dwExtraInfo = 0;
-
-	for (int cur = 0; cur < duration; cur += repeatInterval) {
-		// Press keys
-		ip.ki.dwFlags = 0;
-		for (auto &key : keys) {
-			auto it = keyTable.find(key);
-			if (it == keyTable.end()) {
-				continue;
-			}
-			ip.ki.wVk = it->second;
-			SendInput(1, &ip, sizeof(INPUT));
-		}
-		// When instantly releasing the key presses OBS might miss them
-		Sleep(repeatInterval);
-	}
-
-	// Release keys
-	ip.ki.dwFlags = KEYEVENTF_KEYUP;
-	for (auto &key : keys) {
-		auto it = keyTable.find(key);
+	std::vector<INPUT> inputs;
+	inputs.reserve(events.size());
+	for (const auto &event : events) {
+		auto it = keyTable.find(event.key);
 		if (it == keyTable.end()) {
 			continue;
 		}
+		INPUT ip{};
+		ip.type = INPUT_KEYBOARD;
 		ip.ki.wVk = it->second;
-		SendInput(1, &ip, sizeof(INPUT));
+		ip.ki.dwFlags = event.pressed ? 0 : KEYEVENTF_KEYUP;
+		inputs.push_back(ip);
 	}
+	if (inputs.empty()) {
+		return;
+	}
+	SendInput(static_cast<UINT>(inputs.size()), inputs.data(),
+		  sizeof(INPUT));
 }
 
 static int getLastInputTime()
@@ -549,6 +537,12 @@ int SecondsSinceLastInput()
 	return (getTime() - getLastInputTime()) / 1000;
 }
 
+std::optional<std::pair<int, int>> GetTrackedCursorPos()
+{
+	// Not implemented
+	return {};
+}
+
 static void handleRawMouseInput(LPARAM lParam)
 {
 	UINT dwSize;
@@ -2,6 +2,12 @@
 #include "catch.hpp"
 
 #include <math-helpers.hpp>
+#include <multi-pattern-matcher.hpp>
+#include <region-index.hpp>
+#include <timer-wheel.hpp>
+#include <window-title-filter.hpp>
+
+#include <atomic>
 
 TEST_CASE("Expressions are evaluated successfully", "[math-helpers]")
 {
@@ -94,3 +100,238 @@ TEST_CASE("Invalid expressions are not evaluated", "[math-helpers]")
 
 	REQUIRE(doubleValuePtr == nullptr);
 }
+
+TEST_CASE("Window titles are matched literally and as expressions",
+	  "[window-title-filter]")
+{
+	advss::WindowTitleFilter filter;
+	std::vector<std::string> entries = {"Exact [title]", "Game.*"};
+
+	REQUIRE(filter.Matches(entries, "Exact [title]"));
+	REQUIRE(filter.Matches(entries, "Game - Level 1"));
+	REQUIRE(filter.Matches(entries, "Exact t"));
+	REQUIRE_FALSE(filter.Matches(entries, "Exact title"));
+	REQUIRE_FALSE(filter.Matches(entries, "My Game"));
+	REQUIRE_FALSE(filter.Matches({}, "Exact [title]"));
+
+	// Invalid expressions are still compared literally
+	entries = {"Broken (title", "Other"};
+	REQUIRE(filter.Matches(entries, "Broken (title"));
+	REQUIRE(filter.Matches(entries, "Other"));
+	REQUIRE_FALSE(filter.Matches(entries, "Game - Level 1"));
+}
+
+TEST_CASE("Window title expressions with back references are not combined",
+	  "[window-title-filter]")
+{
+	advss::WindowTitleFilter filter;
+	// Combined into a single alternation \1 would refer to the group of
+	// the first expression
+	const std::vector<std::string> entries = {"(x)y", "(a)\\1", "b+"};
+
+	REQUIRE(filter.Matches(entries, "xy"));
+	REQUIRE(filter.Matches(entries, "aa"));
+	REQUIRE(filter.Matches(entries, "bbb"));
+	REQUIRE_FALSE(filter.Matches(entries, "ax"));
+	REQUIRE_FALSE(filter.Matches(entries, "xx"));
+	REQUIRE_FALSE(filter.Matches(entries, "xyb"));
+}
+
+TEST_CASE("All matching patterns are reported", "[multi-pattern-matcher]")
+{
+	advss::MultiPatternMatcher matcher;
+	matcher.SetPatterns({"abc", "a.*", "x+"});
+
+	REQUIRE(matcher.Match("abc") == std::vector<bool>{true, true, false});
+	REQUIRE(matcher.Match("xx") == std::vector<bool>{false, false, true});
+	// Patterns have to match the whole string
+	REQUIRE(matcher.Match("xabc") ==
+		std::vector<bool>{false, false, false});
+	// Cached results are the same
+	REQUIRE(matcher.Match("abc") == std::vector<bool>{true, true, false});
+
+	// Results of previous patterns are no longer used
+	matcher.SetPatterns({"x+", "abc"});
+	REQUIRE(matcher.Match("abc") == std::vector<bool>{false, true});
+}
+
+TEST_CASE("Patterns with group references are checked separately",
+	  "[multi-pattern-matcher]")
+{
+	advss::MultiPatternMatcher matcher;
+	// Combined into a single expression \1 would refer to the group of
+	// the first pattern
+	matcher.SetPatterns({"(x)y", "(a)\\1", "(?<n>b)\\k<n>"});
+
+	REQUIRE(matcher.Match("xy") == std::vector<bool>{true, false, false});
+	REQUIRE(matcher.Match("aa") == std::vector<bool>{false, true, false});
+	REQUIRE(matcher.Match("bb") == std::vector<bool>{false, false, true});
+	REQUIRE(matcher.Match("ax") ==
+		std::vector<bool>{false, false, false});
+}
+
+TEST_CASE("Invalid patterns never match", "[multi-pattern-matcher]")
+{
+	advss::MultiPatternMatcher matcher;
+	matcher.SetPatterns({"(", "b"});
+
+	REQUIRE_FALSE(matcher.IsValid(0));
+	REQUIRE(matcher.IsValid(1));
+	REQUIRE(matcher.Match("b") == std::vector<bool>{false, true});
+	REQUIRE(matcher.Match("(") == std::vector<bool>{false, false});
+}
+
+TEST_CASE("Region bounds are inclusive", "[region-index]")
+{
+	advss::RegionIndex index;
+	index.Build({{0, 0, 10, 10}});
+	std::vector<size_t> result;
+
+	index.Query(0, 0, result);
+	REQUIRE(result == std::vector<size_t>{0});
+	index.Query(10, 10, result);
+	REQUIRE(result == std::vector<size_t>{0});
+	index.Query(0, 10, result);
+	REQUIRE(result == std::vector<size_t>{0});
+
+	index.Query(11, 10, result);
+	REQUIRE(result.empty());
+	index.Query(-1, 0, result);
+	REQUIRE(result.empty());
+	index.Query(5, 11, result);
+	REQUIRE(result.empty());
+}
+
+TEST_CASE("Regions are found at the edges of grid cells", "[region-index]")
+{
+	// Adjacent tiles sharing their borders, an overlapping region, a
+	// region with negative coordinates, and an empty region
+	std::vector<advss::RegionIndex::Region> regions;
+	for (int row = 0; row < 3; row++) {
+		for (int col = 0; col < 3; col++) {
+			regions.push_back({col * 100, row * 100,
+					   col * 100 + 100, row * 100 + 100});
+		}
+	}
+	regions.push_back({50, 50, 250, 150});
+	regions.push_back({-20, -30, 0, 0});
+	regions.push_back({10, 10, 5, 5});
+
+	advss::RegionIndex index;
+	index.Build(regions);
+	std::vector<size_t> result;
+
+	index.Query(100, 100, result);
+	REQUIRE(result == std::vector<size_t>{0, 1, 3, 4, 9});
+	index.Query(0, 0, result);
+	REQUIRE(result == std::vector<size_t>{0, 10});
+	index.Query(300, 300, result);
+	REQUIRE(result == std::vector<size_t>{8});
+	index.Query(7, 7, result);
+	REQUIRE(result == std::vector<size_t>{0});
+
+	// Compare with checking each region for points around all edges
+	for (int y = -35; y <= 305; y++) {
+		for (int x = -25; x <= 305; x++) {
+			std::vector<size_t> expected;
+			for (size_t i = 0; i < regions.size(); i++) {
+				const auto &r = regions[i];
+				if (x >= r.minX && x <= r.maxX &&
+				    y >= r.minY && y <= r.maxY) {
+					expected.push_back(i);
+				}
+			}
+			index.Query(x, y, result);
+			REQUIRE(result == expected);
+		}
+	}
+}
+
+TEST_CASE("Empty region index finds nothing", "[region-index]")
+{
+	advss::RegionIndex index;
+	std::vector<size_t> result = {1};
+
+	index.Build({});
+	index.Query(0, 0, result);
+	REQUIRE(result.empty());
+
+	index.Build({{5, 5, 0, 0}});
+	index.Query(0, 0, result);
+	REQUIRE(result.empty());
+}
+
+TEST_CASE("Timers run in order across wheel levels", "[timer-wheel]")
+{
+	using namespace std::chrono;
+	advss::TimerWheel wheel;
+	std::mutex mutex;
+	std::vector<int> order;
+	bool early = false;
+
+	// Delays before, at and after the boundaries of the first and second
+	// level, so these timers have to be moved to finer levels
+	const std::vector<int> delays = {600, 5, 257, 255, 513, 256, 511};
+	const auto start = steady_clock::now();
+	for (const auto delay : delays) {
+		const auto deadline = start + milliseconds(delay);
+		wheel.Schedule(deadline, [&, delay, deadline]() {
+			std::lock_guard<std::mutex> lock(mutex);
+			early = early || steady_clock::now() < deadline;
+			order.push_back(delay);
+		});
+	}
+	const auto cancelled = wheel.Schedule(start + milliseconds(520), [&]() {
+		std::lock_guard<std::mutex> lock(mutex);
+		order.push_back(-1);
+	});
+	std::this_thread::sleep_for(milliseconds(300));
+	wheel.Cancel(cancelled);
+	std::this_thread::sleep_for(milliseconds(500));
+
+	std::lock_guard<std::mutex> lock(mutex);
+	REQUIRE_FALSE(early);
+	REQUIRE(order == std::vector<int>{5, 255, 256, 257, 511, 513, 600});
+}
+
+TEST_CASE("Cancelling a running timer waits for it", "[timer-wheel]")
+{
+	using namespace std::chrono;
+	advss::TimerWheel wheel;
+	std::atomic_bool started = {false};
+	std::atomic_bool finished = {false};
+
+	const auto id = wheel.Schedule(steady_clock::now(), [&]() {
+		started = true;
+		std::this_thread::sleep_for(milliseconds(100));
+		finished = true;
+	});
+	while (!started) {
+		std::this_thread::sleep_for(milliseconds(1));
+	}
+	wheel.Cancel(id);
+	REQUIRE(finished);
+}
+
+TEST_CASE("Timers can cancel themselves", "[timer-wheel]")
+{
+	using namespace std::chrono;
+	advss::TimerWheel wheel;
+	std::atomic_bool done = {false};
+	advss::TimerWheel::TimerId id = 0;
+	std::mutex mutex;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		id = wheel.Schedule(steady_clock::now(), [&]() {
+			std::lock_guard<std::mutex> lock(mutex);
+			wheel.Cancel(id);
+			done = true;
+		});
+	}
+	const auto timeout = steady_clock::now() + seconds(5);
+	while (!done && steady_clock::now() < timeout) {
+		std::this_thread::sleep_for(milliseconds(1));
+	}
+	REQUIRE(done);
+}